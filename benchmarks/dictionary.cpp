@@ -0,0 +1,124 @@
+// Times spell checking with Dictionary against the sorted list it replaced,
+// on the word lists given. 200k words are drawn from each list, a quarter of
+// them misspelt and some capitalized or followed by a punctuation mark, and
+// checked 20 times over. The old check lowered the word, dropped a trailing
+// mark and searched the list. The new one probes with the key and hash the
+// transcript computes once when the word is written.
+//
+//   dictionary-benchmark editor/wordlists/*.txt
+
+#include "editor/dictionary.h"
+
+#include <QElapsedTimer>
+#include <QFile>
+#include <algorithm>
+#include <cstdio>
+
+namespace {
+
+constexpr int wordCount = 200000;
+constexpr int rounds = 20;
+
+QStringList readList(const char* fileName)
+{
+    QStringList words;
+    QFile file(QString::fromLocal8Bit(fileName));
+    if (!file.open(QFile::ReadOnly))
+        return words;
+
+    while (!file.atEnd()) {
+        auto line = file.readLine().trimmed();
+        if (!line.isEmpty())
+            words << QString::fromUtf8(line);
+    }
+    return words;
+}
+
+bool oldIsWordCorrect(const QStringList& dictionary, const QString& word)
+{
+    static const QString punctuation(",.!;:");
+
+    auto wordText = word.toLower();
+    if (wordText != "" && punctuation.contains(wordText.back()))
+        wordText = wordText.left(wordText.size() - 1);
+
+    return std::binary_search(dictionary.begin(), dictionary.end(), wordText);
+}
+
+}
+
+int main(int argc, char *argv[])
+{
+    if (argc < 2) {
+        fprintf(stderr, "Usage: %s <word list>...\n", argv[0]);
+        return 1;
+    }
+
+    for (int i = 1; i < argc; i++) {
+        auto list = readList(argv[i]);
+        if (list.isEmpty()) {
+            fprintf(stderr, "Couldn't read %s\n", argv[i]);
+            return 1;
+        }
+
+        auto sorted = list;
+        for (auto& word: sorted)
+            word = word.toLower();
+        std::sort(sorted.begin(), sorted.end());
+
+        Dictionary dictionary;
+        dictionary.reserve(list.size());
+        for (auto& word: qAsConst(list))
+            dictionary.insert(word);
+
+        QStringList words;
+        words.reserve(wordCount);
+        quint32 seed = 1;
+        auto random = [&seed](int bound) {
+            seed = seed * 1664525u + 1013904223u;
+            return int((seed >> 8) % quint32(bound));
+        };
+        for (int j = 0; j < wordCount; j++) {
+            auto word = list[random(list.size())];
+            if (random(4) == 0)
+                word.insert(random(word.size() + 1), QChar('q'));
+            if (random(10) == 0)
+                word[0] = word[0].toUpper();
+            if (random(10) == 0)
+                word.append(QChar(','));
+            words.append(word);
+        }
+
+        // Interned once, as the transcript does when a word is written
+        QVector<int> keys;
+        keys.reserve(wordCount);
+        Dictionary interned;
+        for (auto& word: qAsConst(words))
+            keys.append(interned.insert(word));
+
+        QElapsedTimer timer;
+        timer.start();
+        int oldCorrect = 0;
+        for (int round = 0; round < rounds; round++) {
+            for (auto& word: qAsConst(words))
+                oldCorrect += oldIsWordCorrect(sorted, word);
+        }
+        auto oldTime = timer.elapsed();
+
+        timer.start();
+        int newCorrect = 0;
+        for (int round = 0; round < rounds; round++) {
+            for (auto key: qAsConst(keys))
+                newCorrect += dictionary.contains(interned.key(key), interned.hash(key));
+        }
+        auto newTime = timer.elapsed();
+
+        printf("%s: %d words, %d checks\n", argv[i], list.size(), wordCount * rounds);
+        printf("  sorted list %6lld ms, Dictionary %6lld ms\n", oldTime, newTime);
+        if (oldCorrect != newCorrect)
+            printf("  %d words accepted against %d, the keys are also NFC normalized\n", oldCorrect / rounds,
+                   newCorrect / rounds);
+    }
+
+    return 0;
+}
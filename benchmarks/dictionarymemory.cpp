@@ -0,0 +1,81 @@
+// Measures the resident memory a language takes: its compiled dictionary
+// mapped, the suggestion index built from its keys, and for comparison the
+// word list spelt out from it, which completions and suggestions used to
+// keep. Reads the resident set size from /proc, so it only measures on Linux.
+//
+//   dictionary-memory build/dictionaries/hindi.dic build/dictionaries/gujarati.dic
+
+#include "editor/compileddictionary.h"
+#include "editor/suggestionindex.h"
+
+#include <QElapsedTimer>
+#include <QFile>
+#include <cstdio>
+
+// Kilobytes resident, -1 when unknown
+static qint64 residentKilobytes()
+{
+    QFile status("/proc/self/status");
+    if (!status.open(QFile::ReadOnly))
+        return -1;
+
+    while (!status.atEnd()) {
+        auto line = status.readLine();
+        if (line.startsWith("VmRSS:"))
+            return line.mid(6).trimmed().split(' ').value(0).toLongLong();
+    }
+    return -1;
+}
+
+static void report(const char* what, qint64 before, qint64 after)
+{
+    printf("  %-34s %8.1f MB resident\n", what, (after - before) / 1024.0);
+}
+
+int main(int argc, char *argv[])
+{
+    if (argc < 2) {
+        fprintf(stderr, "Usage: %s <dictionary>...\n", argv[0]);
+        return 1;
+    }
+
+    for (int i = 1; i < argc; i++) {
+        // Memory freed by one dictionary may be reused by the next, so each is kept
+        auto dictionary = new CompiledDictionary;
+        auto start = residentKilobytes();
+        if (!dictionary->load(QString::fromLocal8Bit(argv[i]))) {
+            fprintf(stderr, "Couldn't load %s\n", argv[i]);
+            return 1;
+        }
+
+        // Touch every page of the mapping, as building the index does
+        auto words = 0;
+        for (int index = 0; index < dictionary->size(); index++)
+            words += dictionary->endings(index).size();
+        auto mapped = residentKilobytes();
+
+        QElapsedTimer timer;
+        timer.start();
+        auto index = new SuggestionIndex;
+        index->build(*dictionary);
+        auto buildTime = timer.elapsed();
+        auto indexed = residentKilobytes();
+
+        timer.start();
+        auto lookups = 0;
+        for (int key = 0; key < dictionary->size(); key += 97, lookups++)
+            index->suggestions(*dictionary, dictionary->key(key).mid(1), 5);
+        auto lookupTime = timer.nsecsElapsed() / qMax(1, lookups) / 1000;
+
+        auto spelt = new QStringList(dictionary->words());
+        auto listed = residentKilobytes();
+
+        printf("%s: %d keys, %d words\n", argv[i], dictionary->size(), words);
+        report("dictionary mapped", start, mapped);
+        report("suggestion index", mapped, indexed);
+        report("word list (no longer kept)", indexed, listed);
+        printf("  index built in %lld ms, %lld us a lookup\n", buildTime, lookupTime);
+    }
+
+    return 0;
+}
@@ -0,0 +1,159 @@
+// Times LineParser against the regular expression path fromEditor used to
+// take, on 100k generated "[speaker]: text [hh:mm:ss.zzz]" lines. Some lines
+// have no speaker and some no time stamp, as while a line is being typed.
+// The time stamps stay under 24 hours, which the old path couldn't read.
+// Both paths split the text into words, the old one into strings as it did.
+
+#include "editor/lineparser.h"
+#include "editor/timestamp.h"
+
+#include <QElapsedTimer>
+#include <QRegularExpression>
+#include <QStringList>
+#include <QTime>
+#include <QVector>
+#include <cstdio>
+
+namespace {
+
+constexpr int lineCount = 100000;
+
+QStringList makeLines()
+{
+    const QStringList speakers{"Speaker 1", "Interviewer", "Dr. Rao"};
+    const QStringList words{"the", "recording", "starts", "here", "नमस्ते", "आप", "કેમ", "છો", "okay,", "so"};
+
+    QStringList lines;
+    quint32 seed = 1;
+    auto random = [&seed](int bound) {
+        seed = seed * 1664525u + 1013904223u;
+        return int((seed >> 8) % quint32(bound));
+    };
+
+    for (int i = 0; i < lineCount; i++) {
+        QString line;
+        if (random(10) != 0)
+            line += "[" + speakers[random(speakers.size())] + "]: ";
+        auto wordCount = 3 + random(12);
+        for (int j = 0; j < wordCount; j++)
+            line += (j ? " " : "") + words[random(words.size())];
+        if (random(20) != 0)
+            line += " [" + TimeStamp::format(qint64(i) * 800 + random(800)) + "]";
+        lines.append(line);
+    }
+    return lines;
+}
+
+// The old path, as fromEditor and getTime were
+QTime oldGetTime(const QString& text)
+{
+    if (text.contains(".")) {
+        if (text.count(":") == 2) return QTime::fromString(text, "h:m:s.z");
+        return QTime::fromString(text, "m:s.z");
+    }
+    else {
+        if (text.count(":") == 2) return QTime::fromString(text, "h:m:s");
+        return QTime::fromString(text, "m:s");
+    }
+}
+
+struct OldBlock
+{
+    QTime timeStamp;
+    QString text, speaker;
+    QStringList words;
+};
+
+OldBlock oldParse(const QString& blockText)
+{
+    static const QRegularExpression timeStampExp(R"(\[(\d?\d:)?[0-5]?\d:[0-5]?\d(\.\d\d?\d?)?])");
+    static const QRegularExpression speakerExp(R"(\[.*]:)");
+
+    OldBlock b;
+    QString text;
+
+    QRegularExpressionMatch match = timeStampExp.match(blockText);
+    if (match.hasMatch()) {
+        QString matchedTimeStampString = match.captured();
+        if (blockText.mid(match.capturedEnd()).trimmed() == "") {
+            b.timeStamp = oldGetTime(matchedTimeStampString.mid(1, matchedTimeStampString.size() - 2));
+            text = blockText.split(matchedTimeStampString)[0];
+        }
+    }
+
+    match = speakerExp.match(blockText);
+    if (match.hasMatch()) {
+        auto speaker = match.captured();
+        if (text != "")
+            text = text.split(speaker)[1];
+        speaker = speaker.left(speaker.size() - 2);
+        b.speaker = speaker.right(speaker.size() - 1);
+    }
+
+    if (text == "")
+        text = blockText.trimmed();
+    else
+        text = text.trimmed();
+
+    b.text = text;
+    b.words = text.split(" ");
+    return b;
+}
+
+// The words of a parsed line as views, the way the editor tokenizes it
+int countWords(QStringView text)
+{
+    int words = 0;
+    for (int i = 0; i < text.size(); i++) {
+        if (!text[i].isSpace() && (i == 0 || text[i - 1].isSpace()))
+            words++;
+    }
+    return words;
+}
+
+}
+
+int main()
+{
+    auto lines = makeLines();
+
+    // Each path runs a few times, the fastest run is kept
+    qint64 oldTime = -1, newTime = -1;
+    int oldWords = 0, newWords = 0, disagreements = 0;
+    for (int round = 0; round < 5; round++) {
+        QElapsedTimer timer;
+        timer.start();
+        oldWords = 0;
+        for (auto& line: qAsConst(lines))
+            oldWords += oldParse(line).words.size();
+        auto elapsed = timer.nsecsElapsed();
+        oldTime = oldTime == -1 ? elapsed : qMin(oldTime, elapsed);
+
+        timer.start();
+        newWords = 0;
+        for (auto& line: qAsConst(lines)) {
+            auto parsedLine = LineParser::parse(line);
+            newWords += countWords(parsedLine.text(line));
+        }
+        elapsed = timer.nsecsElapsed();
+        newTime = newTime == -1 ? elapsed : qMin(newTime, elapsed);
+    }
+
+    // Both must read the same time stamps and text
+    for (auto& line: qAsConst(lines)) {
+        auto oldBlock = oldParse(line);
+        auto parsedLine = LineParser::parse(line);
+        auto oldTimeStamp = oldBlock.timeStamp.isValid() ? qint64(oldBlock.timeStamp.msecsSinceStartOfDay())
+                                                         : TimeStamp::invalid;
+        if (oldTimeStamp != parsedLine.timeStamp || oldBlock.text != parsedLine.text(line).toString())
+            disagreements++;
+    }
+
+    printf("%d lines, %d words\n", lines.size(), newWords);
+    printf("  regular expressions %8.1f ms\n", oldTime / 1e6);
+    printf("  LineParser          %8.1f ms, %.0fx faster\n", newTime / 1e6, double(oldTime) / qMax(qint64(1), newTime));
+    if (oldWords != newWords || disagreements)
+        printf("  %d lines read differently, %d words against %d\n", disagreements, oldWords, newWords);
+
+    return 0;
+}
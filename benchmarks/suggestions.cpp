@@ -0,0 +1,103 @@
+// Times spelling suggestions on the compiled dictionaries given, with 2000
+// random typos of one or two edits each. For the first 100 the closest
+// suggestion is checked against a scan of every word in the dictionary.
+//
+//   suggestion-benchmark build/dictionaries/*.dic
+
+#include "editor/compileddictionary.h"
+#include "editor/suggestionindex.h"
+
+#include <QElapsedTimer>
+#include <cstdio>
+
+namespace {
+
+constexpr int typoCount = 2000;
+constexpr int checkedCount = 100;
+
+// The distance of the closest words, maxDistance + 1 when there are none
+int closestDistance(const QStringList& words, const QString& typo)
+{
+    auto closest = SuggestionIndex::maxDistance + 1;
+    for (auto& word: words) {
+        if (word != typo)
+            closest = qMin(closest, SuggestionIndex::distance(typo, word));
+    }
+    return closest;
+}
+
+}
+
+int main(int argc, char *argv[])
+{
+    if (argc < 2) {
+        fprintf(stderr, "Usage: %s <dictionary>...\n", argv[0]);
+        return 1;
+    }
+
+    for (int i = 1; i < argc; i++) {
+        CompiledDictionary dictionary;
+        if (!dictionary.load(QString::fromLocal8Bit(argv[i]))) {
+            fprintf(stderr, "Couldn't load %s\n", argv[i]);
+            return 1;
+        }
+        auto words = dictionary.words();
+
+        QElapsedTimer timer;
+        timer.start();
+        SuggestionIndex index;
+        index.build(dictionary);
+        auto buildTime = timer.elapsed();
+
+        quint32 seed = 1;
+        auto random = [&seed](int bound) {
+            seed = seed * 1664525u + 1013904223u;
+            return int((seed >> 8) % quint32(bound));
+        };
+
+        // Deletions, substitutions and insertions of characters from the same word
+        QStringList typos;
+        for (int j = 0; j < typoCount; j++) {
+            auto typo = words[random(words.size())];
+            auto edits = 1 + random(2);
+            for (int k = 0; k < edits && typo.size() > 1; k++) {
+                auto position = random(typo.size());
+                auto character = typo.at(random(typo.size()));
+                switch (random(3)) {
+                case 0:
+                    typo.remove(position, 1);
+                    break;
+                case 1:
+                    typo[position] = character;
+                    break;
+                default:
+                    typo.insert(position, character);
+                }
+            }
+            typos.append(typo);
+        }
+
+        timer.start();
+        QVector<QStringList> results;
+        results.reserve(typos.size());
+        for (auto& typo: qAsConst(typos))
+            results.append(index.suggestions(dictionary, typo, 5));
+        auto lookupTime = timer.nsecsElapsed() / typos.size() / 1000;
+
+        int missed = 0;
+        for (int j = 0; j < checkedCount; j++) {
+            auto closest = closestDistance(words, typos[j]);
+            auto found = results[j].isEmpty() ? SuggestionIndex::maxDistance + 1
+                                              : SuggestionIndex::distance(typos[j], results[j].first());
+            if (found != closest)
+                missed++;
+        }
+
+        printf("%s: %d keys, %d words\n", argv[i], dictionary.size(), words.size());
+        printf("  index of %.1f MB built in %lld ms, %lld us a lookup\n", index.byteSize() / 1048576.0, buildTime,
+               lookupTime);
+        printf("  closest suggestion missed for %d of %d typos\n", missed, checkedCount);
+    }
+
+    return 0;
+}
@@ -0,0 +1,79 @@
+// Times TimeStamp against QTime on 1M time stamps, parsing them the way
+// getTime did, sniffing the format from the text first, and formatting them
+// as "hh:mm:ss.zzz". The time stamps stay under 24 hours, which QTime can't
+// go past.
+
+#include "editor/timestamp.h"
+
+#include <QElapsedTimer>
+#include <QStringList>
+#include <QTime>
+#include <QVector>
+#include <cstdio>
+
+namespace {
+
+constexpr int count = 1000000;
+
+QTime oldGetTime(const QString& text)
+{
+    if (text.contains(".")) {
+        if (text.count(":") == 2) return QTime::fromString(text, "h:m:s.z");
+        return QTime::fromString(text, "m:s.z");
+    }
+    else {
+        if (text.count(":") == 2) return QTime::fromString(text, "h:m:s");
+        return QTime::fromString(text, "m:s");
+    }
+}
+
+}
+
+int main()
+{
+    QVector<qint64> times;
+    times.reserve(count);
+    quint32 seed = 1;
+    for (int i = 0; i < count; i++) {
+        seed = seed * 1664525u + 1013904223u;
+        times.append(qint64(seed) % TimeStamp::fromParts(24, 0, 0));
+    }
+
+    QStringList texts;
+    texts.reserve(count);
+    for (auto msecs: qAsConst(times))
+        texts.append(TimeStamp::format(msecs));
+
+    QElapsedTimer timer;
+    timer.start();
+    qint64 oldSum = 0;
+    for (auto& text: qAsConst(texts))
+        oldSum += oldGetTime(text).msecsSinceStartOfDay();
+    auto oldParseTime = timer.elapsed();
+
+    timer.start();
+    qint64 newSum = 0;
+    for (auto& text: qAsConst(texts))
+        newSum += TimeStamp::parse(text);
+    auto newParseTime = timer.elapsed();
+
+    timer.start();
+    int oldLength = 0;
+    for (auto msecs: qAsConst(times))
+        oldLength += QTime::fromMSecsSinceStartOfDay(int(msecs)).toString("hh:mm:ss.zzz").size();
+    auto oldFormatTime = timer.elapsed();
+
+    timer.start();
+    int newLength = 0;
+    for (auto msecs: qAsConst(times))
+        newLength += TimeStamp::format(msecs).size();
+    auto newFormatTime = timer.elapsed();
+
+    printf("%d time stamps\n", count);
+    printf("  parse:  QTime::fromString %6lld ms, TimeStamp::parse  %6lld ms\n", oldParseTime, newParseTime);
+    printf("  format: QTime::toString   %6lld ms, TimeStamp::format %6lld ms\n", oldFormatTime, newFormatTime);
+    if (oldSum != newSum || oldLength != newLength)
+        printf("  the two read or wrote the time stamps differently\n");
+
+    return 0;
+}
@@ -1,11 +1,11 @@
 #pragma once
 
 #include <QVector>
-#include <QTime>
+#include <QStringList>
 
 struct word
 {
-    QTime timeStamp;
+    qint64 timeStamp{-1};        // milliseconds, -1 when missing
     QString text;
     QStringList tagList;
 
@@ -19,7 +19,7 @@ struct word
 
 struct block
 {
-    QTime timeStamp;
+    qint64 timeStamp{-1};        // milliseconds, -1 when missing
     QString text;
     QString speaker;
     QStringList tagList;
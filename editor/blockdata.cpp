@@ -0,0 +1,73 @@
+#include "blockdata.h"
+
+#include <algorithm>
+
+namespace {
+
+BlockData* dataOf(QTextBlock& textBlock)
+{
+    auto data = static_cast<BlockData*>(textBlock.userData());
+    if (!data) {
+        data = new BlockData;
+        textBlock.setUserData(data);
+    }
+    return data;
+}
+
+}
+
+BlockData* BlockData::tokenized(QTextBlock textBlock)
+{
+    auto data = dataOf(textBlock);
+    if (data->tokenRevision != data->revision) {
+        data->tokenize(textBlock.text());
+        data->tokenRevision = data->revision;
+    }
+    return data;
+}
+
+// A block without data gets it here, so the edit is counted before anything is cached on it
+void BlockData::edited(QTextBlock textBlock)
+{
+    static int lastRevision = 0;
+    if (textBlock.isValid())
+        dataOf(textBlock)->revision = ++lastRevision;
+}
+
+int BlockData::revisionOf(const QTextBlock& textBlock)
+{
+    auto data = static_cast<BlockData*>(textBlock.userData());
+    return data ? data->revision : 0;
+}
+
+// The word the position is in or right after, -1 before the first word or past the last one
+int BlockData::wordAt(int positionInBlock) const
+{
+    auto next = std::upper_bound(wordStarts.constBegin(), wordStarts.constEnd(), positionInBlock);
+    if (next == wordStarts.constBegin())
+        return -1;
+
+    int wordNumber = next - wordStarts.constBegin() - 1;
+    if (positionInBlock > wordStarts[wordNumber] + wordLengths[wordNumber])
+        return -1;
+    return wordNumber;
+}
+
+void BlockData::tokenize(const QString& blockText)
+{
+    parsedLine = LineParser::parse(blockText);
+    wordStarts.clear();
+    wordLengths.clear();
+
+    // Words are separated by single spaces, like the transcript joins them
+    int end = parsedLine.textStart + parsedLine.textLength;
+    if (parsedLine.textLength == 0)
+        return;
+
+    for (int start = parsedLine.textStart, i = start; i <= end; i++)
+        if (i == end || blockText[i] == QLatin1Char(' ')) {
+            wordStarts.append(start);
+            wordLengths.append(i - start);
+            start = i + 1;
+        }
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include "lineparser.h"
+
+#include <QBitArray>
+#include <QTextBlock>
+#include <QTextBlockUserData>
+#include <QTextLayout>
+#include <QVector>
+
+// Transcript block id, validation results and token offsets cached on a document
+// block, they move along with the block when lines are inserted or removed above it
+struct BlockData : public QTextBlockUserData
+{
+    int id{-1};
+    bool invalidTimeStamp{false};
+    QBitArray invalidWords;     // one bit per word
+    QBitArray unlikelyWords;    // spelt right but unlikely next to their neighbours
+
+    // Set by the editor on every edit to the line, from a count shared by all lines so a revision
+    // isn't seen again on another one. QTextBlock::revision() stands still while the document's undo
+    // stack is disabled, the caches below and the validation passes follow this instead. 0 until the
+    // line is first edited.
+    int revision{0};
+
+    // Formats showing the validation state, built by the highlighter for the token revision they
+    // were computed at, -1 once the validation state changes
+    QVector<QTextLayout::FormatRange> formatSpans;
+    int spanRevision{-1};
+
+    // Parsed line and word offsets, valid for the revision they were computed at
+    int tokenRevision{-1};
+    ParsedLine parsedLine;
+    QVector<int> wordStarts;
+    QVector<int> wordLengths;
+
+    // Returns the block's data with its tokens up to date, creating it if needed
+    static BlockData* tokenized(QTextBlock textBlock);
+    // Gives the block a new revision, its tokens are parsed again when next asked for
+    static void edited(QTextBlock textBlock);
+    static int revisionOf(const QTextBlock& textBlock);
+
+    int wordCount() const { return wordStarts.size(); }
+    int wordAt(int positionInBlock) const;
+    QStringView wordText(const QString& blockText, int wordNumber) const
+    {
+        return QStringView(blockText).mid(wordStarts[wordNumber], wordLengths[wordNumber]);
+    }
+
+private:
+    void tokenize(const QString& blockText);
+};
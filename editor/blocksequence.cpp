@@ -0,0 +1,271 @@
+#include "blocksequence.h"
+
+void BlockSequence::clear()
+{
+    m_nodes.clear();
+    m_root = -1;
+}
+
+int BlockSequence::at(int position) const
+{
+    auto node = m_root;
+    while (node != -1) {
+        auto leftSize = subtreeSize(m_nodes[node].left);
+        if (position < leftSize)
+            node = m_nodes[node].left;
+        else if (position == leftSize)
+            return node;
+        else {
+            position -= leftSize + 1;
+            node = m_nodes[node].right;
+        }
+    }
+    return -1;
+}
+
+int BlockSequence::positionOf(int id) const
+{
+    if (!contains(id))
+        return -1;
+
+    auto position = subtreeSize(m_nodes[id].left);
+    for (auto node = id; m_nodes[node].parent != -1; node = m_nodes[node].parent) {
+        auto parent = m_nodes[node].parent;
+        if (m_nodes[parent].right == node)
+            position += subtreeSize(m_nodes[parent].left) + 1;
+    }
+    return position;
+}
+
+bool BlockSequence::contains(int id) const
+{
+    return id >= 0 && id < m_nodes.size() && m_nodes[id].size > 0;
+}
+
+void BlockSequence::insert(int position, int id)
+{
+    insert(position, QVector<int> {id});
+}
+
+void BlockSequence::insert(int position, const QVector<int>& ids)
+{
+    if (ids.isEmpty())
+        return;
+
+    int inserted = -1;
+    for (auto id: ids)
+        inserted = merge(inserted, makeNode(id));
+
+    int left, right;
+    split(m_root, position, left, right);
+    m_root = merge(merge(left, inserted), right);
+    m_nodes[m_root].parent = -1;
+}
+
+QVector<int> BlockSequence::remove(int position, int count)
+{
+    int left, middle, right;
+    split(m_root, position, left, right);
+    split(right, count, middle, right);
+
+    QVector<int> removed;
+    removed.reserve(subtreeSize(middle));
+    collect(middle, removed);
+    for (auto id: removed)
+        m_nodes[id].size = 0;
+
+    m_root = merge(left, right);
+    if (m_root != -1)
+        m_nodes[m_root].parent = -1;
+    return removed;
+}
+
+QVector<int> BlockSequence::ids(int position, int count) const
+{
+    QVector<int> result;
+    count = qMin(count, size() - position);
+    if (count <= 0)
+        return result;
+
+    result.reserve(count);
+    for (auto node = at(position); result.size() < count;) {
+        result.append(node);
+
+        // Step to the in-order successor
+        if (m_nodes[node].right != -1) {
+            node = m_nodes[node].right;
+            while (m_nodes[node].left != -1)
+                node = m_nodes[node].left;
+        }
+        else {
+            while (m_nodes[node].parent != -1 && m_nodes[m_nodes[node].parent].right == node)
+                node = m_nodes[node].parent;
+            node = m_nodes[node].parent;
+        }
+    }
+    return result;
+}
+
+void BlockSequence::setTime(int id, qint64 time)
+{
+    if (!contains(id))
+        return;
+
+    m_nodes[id].time = time;
+    for (auto node = id; node != -1; node = m_nodes[node].parent) {
+        auto& n = m_nodes[node];
+        n.maxTime = qMax(n.time, qMax(subtreeMaxTime(n.left), subtreeMaxTime(n.right)));
+    }
+}
+
+int BlockSequence::firstAfter(qint64 time) const
+{
+    if (subtreeMaxTime(m_root) <= time)
+        return -1;
+
+    // Every step goes to a subtree known to hold a later time stamp
+    int position = 0;
+    auto node = m_root;
+    while (true) {
+        auto left = m_nodes[node].left;
+        if (subtreeMaxTime(left) > time) {
+            node = left;
+            continue;
+        }
+
+        position += subtreeSize(left);
+        if (m_nodes[node].time > time)
+            return position;
+
+        position++;
+        node = m_nodes[node].right;
+    }
+}
+
+void BlockSequence::setMarks(int id, int count)
+{
+    if (!contains(id) || m_nodes[id].marks == count)
+        return;
+
+    m_nodes[id].marks = count;
+    for (auto node = id; node != -1; node = m_nodes[node].parent) {
+        auto& n = m_nodes[node];
+        n.markSum = n.marks + subtreeMarks(n.left) + subtreeMarks(n.right);
+    }
+}
+
+// Offset is the position of the subtree's first node. Subtrees without marks are skipped, so only
+// the path to position and the one to the result are walked.
+int BlockSequence::firstMarked(int node, int position, int offset) const
+{
+    if (subtreeMarks(node) == 0)
+        return -1;
+
+    auto nodePosition = offset + subtreeSize(m_nodes[node].left);
+    if (position < nodePosition) {
+        auto found = firstMarked(m_nodes[node].left, position, offset);
+        if (found != -1)
+            return found;
+    }
+    if (position <= nodePosition && m_nodes[node].marks > 0)
+        return nodePosition;
+    return firstMarked(m_nodes[node].right, position, nodePosition + 1);
+}
+
+int BlockSequence::lastMarked(int node, int position, int offset) const
+{
+    if (subtreeMarks(node) == 0)
+        return -1;
+
+    auto nodePosition = offset + subtreeSize(m_nodes[node].left);
+    if (position > nodePosition) {
+        auto found = lastMarked(m_nodes[node].right, position, nodePosition + 1);
+        if (found != -1)
+            return found;
+    }
+    if (position >= nodePosition && m_nodes[node].marks > 0)
+        return nodePosition;
+    return lastMarked(m_nodes[node].left, position, offset);
+}
+
+int BlockSequence::makeNode(int id)
+{
+    if (id >= m_nodes.size())
+        m_nodes.resize(id + 1);
+
+    // xorshift32, the priorities only need to be well spread
+    m_seed ^= m_seed << 13;
+    m_seed ^= m_seed >> 17;
+    m_seed ^= m_seed << 5;
+
+    m_nodes[id] = {-1, -1, -1, 1, m_seed, -1, -1, 0, 0};
+    return id;
+}
+
+void BlockSequence::update(int node)
+{
+    auto& n = m_nodes[node];
+    n.size = subtreeSize(n.left) + subtreeSize(n.right) + 1;
+    n.maxTime = qMax(n.time, qMax(subtreeMaxTime(n.left), subtreeMaxTime(n.right)));
+    n.markSum = n.marks + subtreeMarks(n.left) + subtreeMarks(n.right);
+    if (n.left != -1)
+        m_nodes[n.left].parent = node;
+    if (n.right != -1)
+        m_nodes[n.right].parent = node;
+}
+
+// Splits off the first count nodes of the subtree into left, the rest into right
+void BlockSequence::split(int node, int count, int& left, int& right)
+{
+    if (node == -1) {
+        left = right = -1;
+        return;
+    }
+
+    if (subtreeSize(m_nodes[node].left) < count) {
+        int rest;
+        split(m_nodes[node].right, count - subtreeSize(m_nodes[node].left) - 1, rest, right);
+        m_nodes[node].right = rest;
+        left = node;
+    }
+    else {
+        int rest;
+        split(m_nodes[node].left, count, left, rest);
+        m_nodes[node].left = rest;
+        right = node;
+    }
+
+    update(node);
+    if (left != -1)
+        m_nodes[left].parent = -1;
+    if (right != -1)
+        m_nodes[right].parent = -1;
+}
+
+int BlockSequence::merge(int left, int right)
+{
+    if (left == -1)
+        return right;
+    if (right == -1)
+        return left;
+
+    if (m_nodes[left].priority > m_nodes[right].priority) {
+        m_nodes[left].right = merge(m_nodes[left].right, right);
+        update(left);
+        return left;
+    }
+
+    m_nodes[right].left = merge(left, m_nodes[right].left);
+    update(right);
+    return right;
+}
+
+void BlockSequence::collect(int node, QVector<int>& ids) const
+{
+    if (node == -1)
+        return;
+
+    collect(m_nodes[node].left, ids);
+    ids.append(node);
+    collect(m_nodes[node].right, ids);
+}
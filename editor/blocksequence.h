@@ -0,0 +1,80 @@
+#pragma once
+
+#include <QVector>
+
+#include <limits>
+
+// Order of the transcript's blocks, kept as an implicit treap over block ids.
+// Lookups by position, the position of an id and inserting or removing a
+// range of lines all take O(log n), nothing is shifted when lines move.
+//
+// Each id also carries its block's time stamp and every subtree keeps the
+// latest one below it, so the first block ending after a playback position is
+// found in O(log n) even when the time stamps are out of order. Likewise each id
+// carries a count of marks, the editor's misspelt words, and every subtree their
+// sum, so the nearest marked block on either side of a position is found in
+// O(log n) and the total is known without a walk.
+class BlockSequence
+{
+public:
+    void clear();
+    bool isEmpty() const { return m_root == -1; }
+    int size() const { return subtreeSize(m_root); }
+
+    int at(int position) const;
+    int positionOf(int id) const;
+    bool contains(int id) const;
+
+    void insert(int position, int id);
+    void insert(int position, const QVector<int>& ids);
+    QVector<int> remove(int position, int count);
+
+    QVector<int> ids(int position, int count) const;
+    QVector<int> toVector() const { return ids(0, size()); }
+
+    void setTime(int id, qint64 time);
+    // Position of the first block with a time stamp later than time, -1 if there is none
+    int firstAfter(qint64 time) const;
+
+    // Ids inserted again start without marks
+    void setMarks(int id, int count);
+    int marks(int id) const { return contains(id) ? m_nodes[id].marks : 0; }
+    int markCount() const { return subtreeMarks(m_root); }
+    // Position of the first marked block at or after position, of the last one at or before it,
+    // -1 if there is none
+    int firstMarked(int position) const { return firstMarked(m_root, position, 0); }
+    int lastMarked(int position) const { return lastMarked(m_root, position, 0); }
+
+private:
+    struct Node
+    {
+        int left;
+        int right;
+        int parent;
+        int size;
+        quint32 priority;
+        qint64 time;
+        qint64 maxTime;     // latest time stamp in the subtree
+        int marks;
+        int markSum;        // marks in the subtree
+    };
+
+    int subtreeSize(int node) const { return node == -1 ? 0 : m_nodes[node].size; }
+    qint64 subtreeMaxTime(int node) const
+    {
+        return node == -1 ? std::numeric_limits<qint64>::min() : m_nodes[node].maxTime;
+    }
+    int subtreeMarks(int node) const { return node == -1 ? 0 : m_nodes[node].markSum; }
+    int firstMarked(int node, int position, int offset) const;
+    int lastMarked(int node, int position, int offset) const;
+    int makeNode(int id);
+    void update(int node);
+    void split(int node, int count, int& left, int& right);
+    int merge(int left, int right);
+    void collect(int node, QVector<int>& ids) const;
+
+    // Nodes are indexed by block id, unused slots have a size of 0
+    QVector<Node> m_nodes;
+    int m_root{-1};
+    quint32 m_seed{0x9e3779b9};
+};
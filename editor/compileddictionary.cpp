@@ -0,0 +1,460 @@
+#include "compileddictionary.h"
+#include "dictionary.h"
+
+#include <QHash>
+#include <QSet>
+#include <algorithm>
+#include <cstring>
+
+static const char magic[8] = {'A', 'S', 'R', 'D', 'I', 'C', 'T', '\0'};
+
+namespace {
+
+// The flag of a key that is a word as it is, paradigm i is bit i + 1
+constexpr quint32 wordFlag = 1;
+
+struct Entry
+{
+    QString key;
+    quint32 flags;
+
+    bool operator<(const Entry& other) const { return key < other.key; }
+};
+
+struct Suffix
+{
+    QString text;
+    quint32 flags;
+
+    bool operator<(const Suffix& other) const { return text < other.text; }
+};
+
+// Limits of the paradigm search
+constexpr int maxSuffixLength = 4;
+constexpr int minStemLength = 2;
+constexpr int maxSuffixes = 300;
+constexpr int minSuffixCount = 30;
+constexpr int maxParadigms = 31;
+
+bool isSuffix(QStringView text)
+{
+    for (auto c: text) {
+        if (!c.isLetter() && !c.isMark())
+            return false;
+    }
+    return true;
+}
+
+// Both sorted
+int sharedCount(const QVector<int>& a, const QVector<int>& b)
+{
+    return int(std::count_if(a.constBegin(), a.constEnd(), [&b](int id) {
+        return std::binary_search(b.constBegin(), b.constEnd(), id);
+    }));
+}
+
+// Finds the paradigms of the sorted keys and returns the stems taking them
+// along with the keys none of them cover. A stem takes a paradigm only when it
+// is seen with every one of its endings, so no form is accepted that the list
+// doesn't have.
+QVector<Entry> findParadigms(const QStringList& keys, QVector<Suffix>& suffixes)
+{
+    // The commonest endings, the ones with digits or punctuation don't inflect
+    QHash<QString, int> counts;
+    for (auto& key: keys) {
+        for (int length = 1; length <= maxSuffixLength && key.size() - length >= minStemLength; length++) {
+            auto ending = key.right(length);
+            if (isSuffix(ending))
+                counts[ending]++;
+        }
+    }
+
+    QVector<QPair<int, QString>> common;
+    for (auto it = counts.constBegin(); it != counts.constEnd(); ++it) {
+        if (it.value() >= minSuffixCount)
+            common.append({-it.value(), it.key()});
+    }
+    std::sort(common.begin(), common.end());
+    common.resize(qMin(common.size(), maxSuffixes));
+
+    QHash<QString, int> suffixIds;
+    for (int i = 0; i < common.size(); i++)
+        suffixIds.insert(common[i].second, i);
+
+    // The endings each stem is seen with
+    QHash<QString, QVector<int>> stems;
+    for (auto& key: keys) {
+        for (int length = 1; length <= maxSuffixLength && key.size() - length >= minStemLength; length++) {
+            auto id = suffixIds.value(key.right(length), -1);
+            if (id != -1)
+                stems[key.left(key.size() - length)].append(id);
+        }
+    }
+
+    // Sets of endings shared by many stems, by the keys they would save
+    QHash<QVector<int>, int> signatures;
+    for (auto it = stems.begin(); it != stems.end(); ++it) {
+        std::sort(it->begin(), it->end());
+        if (it->size() >= 2)
+            signatures[*it]++;
+    }
+
+    QVector<QPair<int, QVector<int>>> ranked;
+    for (auto it = signatures.constBegin(); it != signatures.constEnd(); ++it)
+        ranked.append({-it.value() * (it.key().size() - 1), it.key()});
+    std::sort(ranked.begin(), ranked.end());
+    ranked.resize(qMin(ranked.size(), maxParadigms));
+
+    QVector<quint32> suffixFlags(common.size());
+    for (int i = 0; i < ranked.size(); i++) {
+        for (auto id: qAsConst(ranked[i].second))
+            suffixFlags[id] |= 2u << i;
+    }
+
+    QHash<QString, quint32> entries;
+    QSet<QString> covered;
+    for (auto it = stems.constBegin(); it != stems.constEnd(); ++it) {
+        quint32 flags = 0;
+        for (int i = 0; i < ranked.size(); i++) {
+            const auto& paradigm = ranked[i].second;
+            auto seen = sharedCount(paradigm, it.value());
+            if (seen >= 2 && seen == paradigm.size()) {
+                flags |= 2u << i;
+                for (auto id: paradigm)
+                    covered.insert(it.key() + common[id].second);
+            }
+        }
+        if (flags)
+            entries.insert(it.key(), flags);
+    }
+
+    for (auto& key: keys) {
+        auto found = entries.find(key);
+        if (found != entries.end())
+            *found |= wordFlag;
+        else if (!covered.contains(key))
+            entries.insert(key, wordFlag);
+    }
+
+    for (int i = 0; i < common.size(); i++) {
+        if (suffixFlags[i])
+            suffixes.append({common[i].second, suffixFlags[i]});
+    }
+    std::sort(suffixes.begin(), suffixes.end());
+
+    QVector<Entry> result;
+    result.reserve(entries.size());
+    for (auto it = entries.constBegin(); it != entries.constEnd(); ++it)
+        result.append({it.key(), it.value()});
+    std::sort(result.begin(), result.end());
+    return result;
+}
+
+}
+
+QByteArray CompiledDictionary::compile(const QStringList& words, bool inferAffixes)
+{
+    QStringList keys;
+    keys.reserve(words.size());
+    for (auto& word: words)
+        keys.append(Dictionary::normalizedKey(word));
+    std::sort(keys.begin(), keys.end());
+    keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+
+    QVector<Entry> entries;
+    QVector<Suffix> suffixes;
+    if (inferAffixes) {
+        entries = findParadigms(keys, suffixes);
+    } else {
+        entries.reserve(keys.size());
+        for (auto& key: keys)
+            entries.append({key, wordFlag});
+    }
+
+    quint32 slotCount = 16;
+    while (slotCount < quint32(entries.size()) * 2)
+        slotCount *= 2;
+
+    QVector<quint32> hashes, offsets{0}, flags, suffixOffsets{0}, suffixFlags;
+    QVector<qint32> slots(int(slotCount), -1);
+    hashes.reserve(entries.size());
+    offsets.reserve(entries.size() + 1);
+    flags.reserve(entries.size());
+    for (int i = 0; i < entries.size(); i++) {
+        auto hash = Dictionary::keyHash(entries[i].key);
+        hashes.append(hash);
+        offsets.append(offsets.last() + quint32(entries[i].key.size()));
+        flags.append(entries[i].flags);
+
+        auto slot = hash & (slotCount - 1);
+        while (slots[int(slot)] != -1)
+            slot = (slot + 1) & (slotCount - 1);
+        slots[int(slot)] = i;
+    }
+    for (auto& suffix: suffixes) {
+        suffixOffsets.append(suffixOffsets.last() + quint32(suffix.text.size()));
+        suffixFlags.append(suffix.flags);
+    }
+
+    Header header;
+    std::memcpy(header.magic, magic, sizeof(magic));
+    header.version = version;
+    header.count = quint32(entries.size());
+    header.slotCount = slotCount;
+    header.textSize = offsets.last();
+    header.suffixCount = quint32(suffixes.size());
+    header.suffixTextSize = suffixOffsets.last();
+
+    auto append = [](QByteArray& data, const QVector<quint32>& table) {
+        data.append(reinterpret_cast<const char*>(table.constData()), table.size() * 4);
+    };
+
+    QByteArray data;
+    data.reserve(int(sizeof(Header) + (hashes.size() * 3 + 1 + slots.size() + suffixes.size() * 2 + 1) * 4
+                     + (header.textSize + header.suffixTextSize) * 2));
+    data.append(reinterpret_cast<const char*>(&header), sizeof(Header));
+    append(data, hashes);
+    append(data, offsets);
+    append(data, flags);
+    data.append(reinterpret_cast<const char*>(slots.constData()), slots.size() * 4);
+    append(data, suffixOffsets);
+    append(data, suffixFlags);
+    for (auto& entry: entries)
+        data.append(reinterpret_cast<const char*>(entry.key.constData()), entry.key.size() * 2);
+    for (auto& suffix: suffixes)
+        data.append(reinterpret_cast<const char*>(suffix.text.constData()), suffix.text.size() * 2);
+    return data;
+}
+
+bool CompiledDictionary::load(const QString& fileName)
+{
+    clear();
+
+    m_file.setFileName(fileName);
+    if (!m_file.open(QFile::ReadOnly))
+        return false;
+
+    // Mapped data must be aligned for the tables, resources aren't always
+    auto size = m_file.size();
+    auto data = m_file.map(0, size);
+    if (data && reinterpret_cast<quintptr>(data) % alignof(quint32) == 0 && attach(data, size))
+        return true;
+
+    if (data)
+        m_file.unmap(data);
+    m_file.seek(0);
+    auto contents = m_file.readAll();
+    m_file.close();
+    return setData(contents);
+}
+
+bool CompiledDictionary::setData(const QByteArray& data)
+{
+    clear();
+    m_data = data;
+    if (attach(reinterpret_cast<const uchar*>(m_data.constData()), m_data.size()))
+        return true;
+
+    m_data.clear();
+    return false;
+}
+
+void CompiledDictionary::clear()
+{
+    m_header = nullptr;
+    m_hashes = m_offsets = m_flags = nullptr;
+    m_slots = nullptr;
+    m_suffixOffsets = m_suffixFlags = nullptr;
+    m_text = m_suffixText = nullptr;
+    m_maxSuffixLength = 0;
+    m_byteSize = 0;
+    m_data.clear();
+    if (m_file.isOpen())
+        m_file.close();
+}
+
+bool CompiledDictionary::contains(QStringView key, uint hash) const
+{
+    auto index = indexOf(key, hash);
+    if (index != -1 && m_flags[index] & wordFlag)
+        return true;
+
+    // Otherwise one of the stems before an ending must take one of its paradigms
+    for (int length = 1; length <= m_maxSuffixLength && length < key.size(); length++) {
+        auto paradigms = suffixFlags(key.right(length));
+        if (!paradigms)
+            continue;
+
+        auto stem = key.left(key.size() - length);
+        auto stemIndex = indexOf(stem, Dictionary::keyHash(stem));
+        if (stemIndex != -1 && m_flags[stemIndex] & paradigms)
+            return true;
+    }
+    return false;
+}
+
+int CompiledDictionary::indexOf(QStringView key, uint hash) const
+{
+    if (!m_header)
+        return -1;
+
+    auto mask = m_header->slotCount - 1;
+    for (auto slot = hash & mask; m_slots[slot] != -1; slot = (slot + 1) & mask) {
+        auto index = m_slots[slot];
+        if (m_hashes[index] == hash && this->key(index) == key)
+            return index;
+    }
+    return -1;
+}
+
+quint32 CompiledDictionary::suffixFlags(QStringView ending) const
+{
+    int first = 0, last = int(m_header->suffixCount);
+    while (first < last) {
+        auto middle = (first + last) / 2;
+        if (suffix(middle) < ending)
+            first = middle + 1;
+        else
+            last = middle;
+    }
+    return first < int(m_header->suffixCount) && suffix(first) == ending ? m_suffixFlags[first] : 0;
+}
+
+int CompiledDictionary::lowerBound(QStringView key) const
+{
+    int first = 0, last = size();
+    while (first < last) {
+        auto middle = (first + last) / 2;
+        if (this->key(middle) < key)
+            first = middle + 1;
+        else
+            last = middle;
+    }
+    return first;
+}
+
+QVector<QStringView> CompiledDictionary::endings(int index) const
+{
+    QVector<QStringView> endings;
+    auto flags = m_flags[index];
+    if (flags & wordFlag)
+        endings.append(QStringView());
+
+    auto paradigms = flags & ~wordFlag;
+    for (int i = 0; paradigms && i < int(m_header->suffixCount); i++) {
+        if (m_suffixFlags[i] & paradigms)
+            endings.append(suffix(i));
+    }
+    return endings;
+}
+
+QStringList CompiledDictionary::completions(QStringView prefix, int count) const
+{
+    QStringList words;
+    if (!m_header || count <= 0)
+        return words;
+
+    auto trim = [&words, count]() {
+        std::sort(words.begin(), words.end());
+        words.erase(std::unique(words.begin(), words.end()), words.end());
+        if (words.size() > count)
+            words.erase(words.begin() + count, words.end());
+    };
+
+    // Stems shorter than the prefix, with the endings that reach past it
+    for (int length = qMax(1, prefix.size() - m_maxSuffixLength); length < prefix.size(); length++) {
+        auto stem = prefix.left(length);
+        auto index = indexOf(stem, Dictionary::keyHash(stem));
+        if (index == -1)
+            continue;
+        for (auto ending: endings(index)) {
+            if (ending.startsWith(prefix.mid(length)))
+                words.append(stem.toString() + ending.toString());
+        }
+    }
+
+    // The keys starting with it in order. A key's words all sort after it, so once count words
+    // come before the next key no later key has a word to add.
+    for (int i = lowerBound(prefix); i < size() && key(i).startsWith(prefix); i++) {
+        if (words.size() >= count) {
+            trim();
+            if (words.size() == count && !(key(i) < QStringView(words.last())))
+                break;
+        }
+        for (auto ending: endings(i))
+            words.append(key(i).toString() + ending.toString());
+    }
+
+    trim();
+    return words;
+}
+
+QStringList CompiledDictionary::words() const
+{
+    // The endings of each paradigm
+    QVector<QVector<int>> paradigms(32);
+    for (int i = 0; i < int(m_header ? m_header->suffixCount : 0); i++) {
+        for (int bit = 1; bit < 32; bit++) {
+            if (m_suffixFlags[i] & (1u << bit))
+                paradigms[bit].append(i);
+        }
+    }
+
+    QStringList words;
+    words.reserve(size());
+    for (int i = 0; i < size(); i++) {
+        if (m_flags[i] & wordFlag)
+            words.append(key(i).toString());
+        for (int bit = 1; bit < 32; bit++) {
+            if (!(m_flags[i] & (1u << bit)))
+                continue;
+            for (auto suffix: qAsConst(paradigms[bit]))
+                words.append(key(i).toString() + this->suffix(suffix).toString());
+        }
+    }
+
+    // Only a list with affixes is out of order
+    if (m_header && m_header->suffixCount) {
+        std::sort(words.begin(), words.end());
+        words.erase(std::unique(words.begin(), words.end()), words.end());
+    }
+    return words;
+}
+
+// Only the sizes are checked, a file written on a machine with the other byte
+// order fails on the version
+bool CompiledDictionary::attach(const uchar* data, qint64 size)
+{
+    if (size < qint64(sizeof(Header)))
+        return false;
+
+    auto header = reinterpret_cast<const Header*>(data);
+    if (std::memcmp(header->magic, magic, sizeof(magic)) != 0 || header->version != version)
+        return false;
+
+    auto slotCount = header->slotCount;
+    if (slotCount == 0 || (slotCount & (slotCount - 1)) || header->count >= slotCount)
+        return false;
+
+    auto tables = qint64(header->count) * 3 + 1 + slotCount + qint64(header->suffixCount) * 2 + 1;
+    auto text = qint64(header->textSize) + header->suffixTextSize;
+    if (size != qint64(sizeof(Header)) + tables * 4 + text * 2)
+        return false;
+
+    auto words = reinterpret_cast<const quint32*>(data + sizeof(Header));
+    m_header = header;
+    m_hashes = words;
+    m_offsets = m_hashes + header->count;
+    m_flags = m_offsets + header->count + 1;
+    m_slots = reinterpret_cast<const qint32*>(m_flags + header->count);
+    m_suffixOffsets = reinterpret_cast<const quint32*>(m_slots + slotCount);
+    m_suffixFlags = m_suffixOffsets + header->suffixCount + 1;
+    m_text = reinterpret_cast<const QChar*>(m_suffixFlags + header->suffixCount);
+    m_suffixText = m_text + header->textSize;
+    m_byteSize = size;
+
+    m_maxSuffixLength = 0;
+    for (int i = 0; i < int(header->suffixCount); i++)
+        m_maxSuffixLength = qMax(m_maxSuffixLength, suffix(i).size());
+    return true;
+}
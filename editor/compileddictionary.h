@@ -0,0 +1,107 @@
+#pragma once
+
+#include <QByteArray>
+#include <QFile>
+#include <QString>
+#include <QStringList>
+#include <QStringView>
+#include <QVector>
+
+// Read-only set of spelling keys in a precompiled format, used in place from a
+// mapped file without any parsing. The keys are the ones of Dictionary and are
+// stored sorted.
+//
+// A list compiled with affixes holds stems instead of most of its inflected
+// forms. Endings that many stems take together are grouped into paradigms, a
+// stem's flags name the paradigms it takes and a word not stored as it is
+// matches when a stem with one of its ending's paradigms precedes the ending.
+//
+// Layout, native byte order:
+//   Header
+//   quint32 hashes[count]
+//   quint32 offsets[count + 1]   key i is text[offsets[i], offsets[i + 1])
+//   quint32 flags[count]         bit 0 when the key is a word, bit i + 1 for paradigm i
+//   qint32  slots[slotCount]     open addressing on the hash, -1 when empty
+//   quint32 suffixOffsets[suffixCount + 1]
+//   quint32 suffixFlags[suffixCount]    the paradigms the ending belongs to
+//   char16  text[]               UTF-16 so keys can be viewed without decoding
+//   char16  suffixText[]         the endings, sorted
+class CompiledDictionary
+{
+public:
+    CompiledDictionary() = default;
+    CompiledDictionary(const CompiledDictionary&) = delete;
+    CompiledDictionary& operator=(const CompiledDictionary&) = delete;
+
+    // With inferAffixes the paradigms are found from the list itself. Either
+    // way the dictionary accepts the words of the list and no others.
+    static QByteArray compile(const QStringList& words, bool inferAffixes = false);
+
+    // Maps the file, reading it instead when it can't be mapped. Returns false
+    // when the file is missing or isn't a compiled dictionary.
+    bool load(const QString& fileName);
+    bool setData(const QByteArray& data);
+    void clear();
+
+    bool isEmpty() const { return size() == 0; }
+    int size() const { return m_header ? int(m_header->count) : 0; }
+    // Bytes of the data in use, mapped or read
+    qint64 byteSize() const { return m_byteSize; }
+
+    bool contains(QStringView key, uint hash) const;
+    // The first count words accepted that start with the prefix, sorted. Only the stems and keys
+    // starting with it are read, nothing is spelt out ahead of time.
+    QStringList completions(QStringView prefix, int count) const;
+    // Every word accepted, the stems' forms spelt out, sorted. For joining dictionaries, it takes
+    // more memory than the dictionary itself.
+    QStringList words() const;
+
+    // The keys in order, each stands for itself when it is a word and for its forms with the
+    // endings of its paradigms
+    QStringView key(int index) const
+    {
+        return QStringView(m_text + m_offsets[index], int(m_offsets[index + 1] - m_offsets[index]));
+    }
+    // The endings the key takes to make the words it stands for, sorted, an empty one when it is
+    // a word as it is. An ending in two of its paradigms is listed once.
+    QVector<QStringView> endings(int index) const;
+
+private:
+    struct Header
+    {
+        char magic[8];
+        quint32 version;
+        quint32 count;
+        quint32 slotCount;
+        quint32 textSize;
+        quint32 suffixCount;
+        quint32 suffixTextSize;
+    };
+
+    static constexpr quint32 version = 2;
+
+    bool attach(const uchar* data, qint64 size);
+    int indexOf(QStringView key, uint hash) const;
+    int lowerBound(QStringView key) const;
+    quint32 suffixFlags(QStringView ending) const;
+
+    QStringView suffix(int index) const
+    {
+        return QStringView(m_suffixText + m_suffixOffsets[index],
+                           int(m_suffixOffsets[index + 1] - m_suffixOffsets[index]));
+    }
+
+    QFile m_file;
+    QByteArray m_data;
+    qint64 m_byteSize{0};
+    const Header* m_header = nullptr;
+    const quint32* m_hashes = nullptr;
+    const quint32* m_offsets = nullptr;
+    const quint32* m_flags = nullptr;
+    const qint32* m_slots = nullptr;
+    const quint32* m_suffixOffsets = nullptr;
+    const quint32* m_suffixFlags = nullptr;
+    const QChar* m_text = nullptr;
+    const QChar* m_suffixText = nullptr;
+    int m_maxSuffixLength{0};
+};
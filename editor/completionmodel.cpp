@@ -0,0 +1,91 @@
+#include "completionmodel.h"
+#include "dictionary.h"
+
+#include <algorithm>
+
+constexpr int CompletionModel::maxRows;
+
+CompletionModel::CompletionModel(QObject* parent)
+    : QAbstractListModel(parent)
+{
+}
+
+void CompletionModel::setWords(const QSharedPointer<const LanguageDictionary>& dictionary,
+                               const QStringList& extraWords)
+{
+    m_dictionary = dictionary;
+    m_extraWords = extraWords;
+    updateRows();
+}
+
+void CompletionModel::addWord(const QString& word)
+{
+    auto position = std::lower_bound(m_extraWords.begin(), m_extraWords.end(), word);
+    if (position != m_extraWords.end() && *position == word)
+        return;
+
+    m_extraWords.insert(position, word);
+    if (!m_prefix.isEmpty() && word.startsWith(m_prefix))
+        updateRows();
+}
+
+void CompletionModel::setPrefix(const QString& prefix, const QStringList& predictions)
+{
+    auto key = Dictionary::normalizedKey(prefix);
+    if (key == m_prefix && predictions == m_predictions)
+        return;
+
+    m_prefix = key;
+    m_predictions = predictions;
+    updateRows();
+}
+
+int CompletionModel::rowCount(const QModelIndex& parent) const
+{
+    return parent.isValid() ? 0 : m_rows.size();
+}
+
+QVariant CompletionModel::data(const QModelIndex& index, int role) const
+{
+    if (!index.isValid() || index.row() >= m_rows.size() || (role != Qt::DisplayRole && role != Qt::EditRole))
+        return QVariant();
+    return m_rows[index.row()];
+}
+
+// The predictions, then the dictionary's completions and the extra words with the prefix merged, a
+// word is listed once
+void CompletionModel::updateRows()
+{
+    auto rows = m_predictions.mid(0, maxRows);
+    auto append = [&rows, this](const QString& word) {
+        if (!m_predictions.contains(word))
+            rows.append(word);
+    };
+
+    if (!m_prefix.isEmpty()) {
+        auto words = m_dictionary ? m_dictionary->words.completions(m_prefix, maxRows) : QStringList();
+        auto word = words.constBegin();
+        auto extraWord = std::lower_bound(m_extraWords.constBegin(), m_extraWords.constEnd(), m_prefix);
+
+        while (rows.size() < maxRows) {
+            auto hasWord = word != words.constEnd();
+            auto hasExtraWord = extraWord != m_extraWords.constEnd() && extraWord->startsWith(m_prefix);
+            if (hasWord && (!hasExtraWord || *word < *extraWord))
+                append(*word++);
+            else if (hasExtraWord) {
+                if (hasWord && *word == *extraWord)
+                    ++word;
+                append(*extraWord++);
+            }
+            else
+                break;
+        }
+    }
+
+    if (rows == m_rows)
+        return;
+
+    beginResetModel();
+    m_rows = rows;
+    endResetModel();
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include "dictionarymanager.h"
+
+#include <QAbstractListModel>
+#include <QSharedPointer>
+#include <QString>
+#include <QStringList>
+
+// Completions of the word being typed. The dictionary gives its first words
+// with a prefix from the stems that can start them, the extra words are sorted
+// so theirs are a range found by binary search, and only the first maxRows
+// become rows. The completer then filters and lays out a few rows on each key
+// press whatever the size of the dictionary. Words predicted from the words
+// before the cursor come first.
+class CompletionModel : public QAbstractListModel
+{
+    Q_OBJECT
+
+public:
+    static constexpr int maxRows = 50;
+
+    explicit CompletionModel(QObject* parent = nullptr);
+
+    // The extra words are sorted spelling keys, the dictionary may be null while it loads
+    void setWords(const QSharedPointer<const LanguageDictionary>& dictionary, const QStringList& extraWords);
+    // Adds a word marked as correct, the rows change only when it has the current prefix
+    void addWord(const QString& word);
+
+    QString prefix() const { return m_prefix; }
+    // The predictions are keys, most likely first, and may be had with an empty prefix
+    void setPrefix(const QString& prefix, const QStringList& predictions = QStringList());
+
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+
+private:
+    void updateRows();
+
+    QSharedPointer<const LanguageDictionary> m_dictionary;
+    QStringList m_extraWords;
+    QString m_prefix;           // as a spelling key, words are matched against it
+    QStringList m_predictions;
+    QStringList m_rows;
+};
@@ -0,0 +1,60 @@
+#include "correctedwords.h"
+
+#include <QFile>
+#include <QSaveFile>
+
+void CorrectedWords::load(const QString& language)
+{
+    clear();
+    m_fileName = QString("corrected_words_%1.txt").arg(language);
+
+    QFile file(m_fileName);
+    if (!file.open(QFile::ReadOnly))
+        return;
+
+    int lineCount = 0;
+    while (!file.atEnd()) {
+        QByteArray line = file.readLine().trimmed();
+        if (line.isEmpty())
+            continue;
+        m_keys.insert(QString::fromUtf8(line));
+        lineCount++;
+    }
+    file.close();
+
+    if (lineCount > m_keys.size() * 2)
+        compact();
+}
+
+void CorrectedWords::clear()
+{
+    m_fileName.clear();
+    m_keys.clear();
+}
+
+bool CorrectedWords::append(QStringView key, uint hash)
+{
+    m_keys.insertKey(key, hash);
+
+    QFile file(m_fileName);
+    if (!file.open(QFile::WriteOnly | QFile::Append))
+        return false;
+
+    auto line = key.toUtf8();
+    line.append('\n');
+    return file.write(line) == line.size();
+}
+
+void CorrectedWords::compact()
+{
+    QSaveFile file(m_fileName);
+    if (!file.open(QFile::WriteOnly))
+        return;
+
+    for (int i = 0; i < m_keys.size(); i++) {
+        auto line = m_keys.key(i).toUtf8();
+        line.append('\n');
+        file.write(line);
+    }
+    file.commit();
+}
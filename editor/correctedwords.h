@@ -0,0 +1,32 @@
+#pragma once
+
+#include "dictionary.h"
+
+#include <QString>
+#include <QStringList>
+#include <QStringView>
+
+// Words marked as correct for a language, kept one key per line in
+// corrected_words_<language>.txt. Marking a word only appends its line, the
+// file is rewritten without the duplicates when loading finds it has grown to
+// more than twice the words it holds.
+class CorrectedWords
+{
+public:
+    void load(const QString& language);
+    void clear();
+
+    bool contains(QStringView key, uint hash) const { return m_keys.contains(key, hash); }
+    const Dictionary& keySet() const { return m_keys; }
+    // The keys in the order they were marked
+    QStringList keys() const { return m_keys.keys(); }
+
+    // Adds a key that isn't in yet, returns false when it couldn't be written to the file
+    bool append(QStringView key, uint hash);
+
+private:
+    void compact();
+
+    QString m_fileName;
+    Dictionary m_keys;
+};
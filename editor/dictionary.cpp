@@ -0,0 +1,141 @@
+#include "dictionary.h"
+
+bool Dictionary::isPunctuation(QChar c)
+{
+    switch (c.unicode()) {
+    case ',': case '.': case '!': case ';': case ':':
+        return true;
+    default:
+        return false;
+    }
+}
+
+QString Dictionary::normalizedKey(QStringView word)
+{
+    if (!word.isEmpty() && isPunctuation(word.back()))
+        word.chop(1);
+
+    // Most words are plain ASCII, those only need lowering
+    bool ascii = true;
+    for (auto c: word)
+        if (c.unicode() >= 0x80) {
+            ascii = false;
+            break;
+        }
+
+    if (ascii) {
+        QString key(word.size(), Qt::Uninitialized);
+        auto out = key.data();
+        for (auto c: word) {
+            auto u = c.unicode();
+            *out++ = QChar(ushort(u >= 'A' && u <= 'Z' ? u + ('a' - 'A') : u));
+        }
+        return key;
+    }
+
+    return word.toString().toCaseFolded().normalized(QString::NormalizationForm_C);
+}
+
+// FNV-1a over the UTF-16 code units, the value must not change between runs
+uint Dictionary::keyHash(QStringView key)
+{
+    uint hash = 2166136261u;
+    for (auto c: key) {
+        hash ^= c.unicode();
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+void Dictionary::clear()
+{
+    m_text.clear();
+    m_offsets.clear();
+    m_lengths.clear();
+    m_hashes.clear();
+    m_slots.clear();
+}
+
+void Dictionary::reserve(int count)
+{
+    m_offsets.reserve(count);
+    m_lengths.reserve(count);
+    m_hashes.reserve(count);
+
+    int slotCount = 16;
+    while (slotCount < count * 2)
+        slotCount *= 2;
+    if (slotCount > m_slots.size())
+        rehash(slotCount);
+}
+
+int Dictionary::insert(QStringView word)
+{
+    auto key = normalizedKey(word);
+    return insertKey(key, keyHash(key));
+}
+
+int Dictionary::insertKey(QStringView key, uint hash)
+{
+    auto index = indexOf(key, hash);
+    if (index != -1)
+        return index;
+
+    // At most half the slots are used, so probes stay short
+    if ((size() + 1) * 2 > m_slots.size())
+        rehash(qMax(16, m_slots.size() * 2));
+
+    m_offsets.append(m_text.size());
+    m_lengths.append(key.size());
+    m_hashes.append(hash);
+    m_text.append(key.data(), key.size());
+
+    auto mask = m_slots.size() - 1;
+    auto slot = int(hash & mask);
+    while (m_slots[slot] != -1)
+        slot = (slot + 1) & mask;
+    m_slots[slot] = size() - 1;
+    return size() - 1;
+}
+
+bool Dictionary::containsWord(QStringView word) const
+{
+    auto key = normalizedKey(word);
+    return contains(key, keyHash(key));
+}
+
+QStringList Dictionary::keys() const
+{
+    QStringList keys;
+    keys.reserve(size());
+    for (int i = 0; i < size(); i++)
+        keys.append(key(i).toString());
+    return keys;
+}
+
+int Dictionary::indexOf(QStringView key, uint hash) const
+{
+    if (m_slots.isEmpty())
+        return -1;
+
+    auto mask = m_slots.size() - 1;
+    for (auto slot = int(hash & mask); m_slots[slot] != -1; slot = (slot + 1) & mask) {
+        auto index = m_slots[slot];
+        if (m_hashes[index] == hash && this->key(index) == key)
+            return index;
+    }
+    return -1;
+}
+
+void Dictionary::rehash(int slotCount)
+{
+    m_slots.fill(-1, slotCount);
+
+    auto mask = slotCount - 1;
+    for (int i = 0; i < size(); i++) {
+        auto slot = int(m_hashes[i] & mask);
+        while (m_slots[slot] != -1)
+            slot = (slot + 1) & mask;
+        m_slots[slot] = i;
+    }
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <QString>
+#include <QStringList>
+#include <QStringView>
+#include <QVector>
+
+// Set of spelling keys with open addressing. Words are looked up by their key:
+// case folded, NFC normalized and without one trailing punctuation mark, so a
+// caller holding the key and its hash checks a word with a single probe and
+// no allocation.
+class Dictionary
+{
+public:
+    static QString normalizedKey(QStringView word);
+    static uint keyHash(QStringView key);
+    // A mark at the end of a word that isn't part of its key
+    static bool isPunctuation(QChar c);
+
+    void clear();
+    void reserve(int count);
+    bool isEmpty() const { return m_offsets.isEmpty(); }
+    int size() const { return m_offsets.size(); }
+
+    // Adds the word's key and returns its index, keys are never removed so indexes stay valid
+    int insert(QStringView word);
+    int insertKey(QStringView key, uint hash);
+
+    int indexOf(QStringView key, uint hash) const;
+    bool contains(QStringView key, uint hash) const { return indexOf(key, hash) != -1; }
+    bool containsWord(QStringView word) const;
+
+    QStringView key(int index) const { return QStringView(m_text.constData() + m_offsets[index], m_lengths[index]); }
+    uint hash(int index) const { return m_hashes[index]; }
+    // The keys in the order they were inserted
+    QStringList keys() const;
+
+private:
+    void rehash(int slotCount);
+
+    // Keys are stored back to back in one string, the slots hold their index or -1
+    QString m_text;
+    QVector<int> m_offsets;
+    QVector<int> m_lengths;
+    QVector<uint> m_hashes;
+    QVector<int> m_slots;
+};
@@ -0,0 +1,158 @@
+#include "dictionarymanager.h"
+
+#include <QCoreApplication>
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QRunnable>
+#include <QStandardPaths>
+
+#include <functional>
+
+namespace {
+
+class LoadTask : public QRunnable
+{
+public:
+    LoadTask(const std::function<void()>& function) : m_function(function) {}
+    void run() override { m_function(); }
+
+private:
+    std::function<void()> m_function;
+};
+
+}
+
+DictionaryManager* DictionaryManager::instance()
+{
+    // Owned by the application so the pool is stopped before it exits
+    static auto manager = new DictionaryManager(QCoreApplication::instance());
+    return manager;
+}
+
+DictionaryManager::DictionaryManager(QObject* parent)
+    : QObject(parent)
+{
+}
+
+DictionaryManager::~DictionaryManager()
+{
+    m_pool.clear();
+    m_pool.waitForDone();
+}
+
+QSharedPointer<const LanguageDictionary> DictionaryManager::dictionary(const QString& language)
+{
+    auto found = m_resident.constFind(language);
+    if (found != m_resident.constEnd()) {
+        touch(language);
+        return found.value();
+    }
+
+    // Languages asked for together load side by side
+    if (!m_loading.contains(language)) {
+        m_loading.append(language);
+        m_pool.start(new LoadTask([this, language]() {
+            auto dictionary = load(language);
+            QMetaObject::invokeMethod(this, [this, dictionary]() { loaded(dictionary); });
+        }));
+    }
+    return {};
+}
+
+void DictionaryManager::setMemoryLimit(qint64 bytes)
+{
+    m_memoryLimit = bytes;
+    evict();
+}
+
+// Runs on the pool
+QSharedPointer<const LanguageDictionary> DictionaryManager::load(const QString& language)
+{
+    auto dictionary = QSharedPointer<LanguageDictionary>::create();
+    dictionary->language = language;
+
+    // Lists compiled at build time are mapped as they are, a union of several and a language with
+    // only a plain list are compiled from their words
+    if (language.contains('+') || !dictionary->words.load(QString(":/dictionaries/%1.dic").arg(language))) {
+        QStringList words;
+        for (auto& part: language.split('+', Qt::SkipEmptyParts))
+            words += readWords(part);
+        dictionary->words.setData(CompiledDictionary::compile(words));
+    }
+
+    // Completions are read from the dictionary as they are asked for, suggestions are looked up by
+    // its keys, so its words are never all spelt out
+    dictionary->suggestions.build(dictionary->words);
+
+    // Built from corrected transcripts outside the build, installed beside the executable or in the
+    // application's data directory
+    auto modelName = QString("ngrams_%1.bin").arg(language);
+    auto modelPath = QDir(QCoreApplication::applicationDirPath()).filePath(modelName);
+    if (!QFile::exists(modelPath))
+        modelPath = QStandardPaths::locate(QStandardPaths::AppDataLocation, modelName);
+    if (!modelPath.isEmpty())
+        dictionary->phrases.load(modelPath);
+
+    dictionary->byteSize = dictionary->words.byteSize() + dictionary->suggestions.byteSize()
+                           + dictionary->phrases.byteSize();
+
+    return dictionary;
+}
+
+// The words of a compiled dictionary, or of a plain list, one word a line, for a language the build
+// didn't compile. The list is looked for in the resources, then beside the executable and in the
+// application's data directory under wordlists/.
+QStringList DictionaryManager::readWords(const QString& language)
+{
+    CompiledDictionary compiled;
+    if (compiled.load(QString(":/dictionaries/%1.dic").arg(language)))
+        return compiled.words();
+
+    auto listName = QString("wordlists/%1.txt").arg(language);
+    auto listPath = ":/" + listName;
+    if (!QFile::exists(listPath))
+        listPath = QDir(QCoreApplication::applicationDirPath()).filePath(listName);
+    if (!QFile::exists(listPath))
+        listPath = QStandardPaths::locate(QStandardPaths::AppDataLocation, listName);
+
+    QStringList words;
+    QFile file(listPath);
+    if (listPath.isEmpty() || !file.open(QFile::ReadOnly)) {
+        qWarning() << "[Dictionary Missing]" << QString("no compiled dictionary or word list for %1").arg(language);
+        return words;
+    }
+
+    while (!file.atEnd()) {
+        auto line = file.readLine().trimmed();
+        if (!line.isEmpty())
+            words << QString::fromUtf8(line);
+    }
+    return words;
+}
+
+void DictionaryManager::loaded(const QSharedPointer<const LanguageDictionary>& dictionary)
+{
+    m_loading.removeOne(dictionary->language);
+    m_resident.insert(dictionary->language, dictionary);
+    m_memoryUsed += dictionary->byteSize;
+    touch(dictionary->language);
+    evict();
+
+    emit dictionaryReady(dictionary->language);
+}
+
+void DictionaryManager::touch(const QString& language)
+{
+    m_recent.removeOne(language);
+    m_recent.prepend(language);
+}
+
+// Editors still using an evicted dictionary keep their reference to it
+void DictionaryManager::evict()
+{
+    while (m_recent.size() > 1 && m_memoryUsed > m_memoryLimit) {
+        auto language = m_recent.takeLast();
+        m_memoryUsed -= m_resident.take(language)->byteSize;
+    }
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include "compileddictionary.h"
+#include "ngrammodel.h"
+#include "suggestionindex.h"
+
+#include <QHash>
+#include <QObject>
+#include <QSharedPointer>
+#include <QStringList>
+#include <QThreadPool>
+
+// A loaded language, shared read-only by every editor using it
+struct LanguageDictionary
+{
+    QString language;
+    CompiledDictionary words;
+    SuggestionIndex suggestions;    // over the keys of words
+    NGramModel phrases;             // empty when the language has no model
+    qint64 byteSize{0};             // estimated memory held by the three above
+};
+
+// Loads dictionaries on a thread pool and keeps the recently used languages
+// resident, dropping the least recently used ones past the memory limit. The
+// language last asked for is always kept. Only used from the GUI thread.
+//
+// A language may be several joined by '+', "english+hindi", the dictionary
+// then holds the words of all of them so a word is still checked with one probe.
+class DictionaryManager : public QObject
+{
+    Q_OBJECT
+
+public:
+    static DictionaryManager* instance();
+
+    // The language's dictionary when it is resident. Otherwise returns null and
+    // starts loading it, dictionaryReady() is emitted once it can be had.
+    QSharedPointer<const LanguageDictionary> dictionary(const QString& language);
+
+    void setMemoryLimit(qint64 bytes);
+    qint64 memoryLimit() const { return m_memoryLimit; }
+    qint64 memoryUsed() const { return m_memoryUsed; }
+
+signals:
+    void dictionaryReady(const QString& language);
+
+private:
+    explicit DictionaryManager(QObject* parent = nullptr);
+    ~DictionaryManager() override;
+
+    static QSharedPointer<const LanguageDictionary> load(const QString& language);
+    static QStringList readWords(const QString& language);
+    void loaded(const QSharedPointer<const LanguageDictionary>& dictionary);
+    void touch(const QString& language);
+    void evict();
+
+    QThreadPool m_pool;
+
+    QHash<QString, QSharedPointer<const LanguageDictionary>> m_resident;
+    QStringList m_recent;       // resident languages, most recently used first
+    QStringList m_loading;
+    // A language of 100k words takes about 20 MB, nearly all of it the suggestion index, and a
+    // union of two about twice that. This keeps the transcript's language, the couple its lines
+    // are tagged with and their union resident.
+    qint64 m_memoryLimit{96 * 1024 * 1024};
+    qint64 m_memoryUsed{0};
+};
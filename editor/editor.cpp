@@ -13,27 +13,54 @@
 #include <algorithm>
 #include <QEventLoop>
 #include <QDebug>
+#include <QHelpEvent>
+#include <QToolTip>
+#include <QHash>
+#include <QSet>
 
 Editor::Editor(QWidget *parent)
     : TextEditor(parent),
     m_speakerCompleter(makeCompleter()), m_textCompleter(makeCompleter()), m_transliterationCompleter(makeCompleter()),
-    m_dictionary(listFromFile(":/wordlists/english.txt")), m_transcriptLang("english"),
-    timeStampExp(QRegularExpression(R"(\[(\d?\d:)?[0-5]?\d:[0-5]?\d(\.\d\d?\d?)?])")),
-    speakerExp(QRegularExpression(R"(\[.*]:)")),
+    m_transcriptLang("english"),
     m_saveTimer(new QTimer(this))
 {
     connect(this->document(), &QTextDocument::contentsChange, this, &Editor::contentChanged);
+    // Undo and redo go through the transcript's history, the document's own would bypass the model
+    document()->setUndoRedoEnabled(false);
+    m_highlighter = new Highlighter(document());
+    connect(this, &Editor::blockCountChanged, m_highlighter, &Highlighter::linesMoved);
     connect(this, &Editor::cursorPositionChanged, this, &Editor::updateWordEditor);
     connect(this, &Editor::cursorPositionChanged, this,
     [&]()
     {
-        if (!m_blocks.isEmpty() && textCursor().blockNumber() < m_blocks.size())
-            emit refreshTagList(m_blocks[textCursor().blockNumber()].tagList);
+        if (!m_transcript.isEmpty() && textCursor().blockNumber() < m_transcript.blockCount())
+            emit refreshTagList(m_transcript.blockTags(textCursor().blockNumber()));
     });
 
-    m_textCompleter->setModelSorting(QCompleter::CaseInsensitivelySortedModel);
+    // The model holds only the matches of the prefix, the completer shows them as they are
+    m_completionModel = new CompletionModel(m_textCompleter);
+    m_textCompleter->setModel(m_completionModel);
+    m_textCompleter->setCompletionMode(QCompleter::UnfilteredPopupCompletion);
     m_transliterationCompleter->setModel(new QStringListModel);
 
+    // Shared by the speaker completer and the change speaker dialog, refreshed when speakers come or go
+    m_speakerModel = new QStringListModel(this);
+    m_speakerCompleter->setModel(m_speakerModel);
+
+    // Dictionaries load in the background, words are checked once this editor's is in
+    connect(DictionaryManager::instance(), &DictionaryManager::dictionaryReady, this,
+    [this](const QString& language)
+    {
+        if (language == m_transcriptLang && !m_dictionary) {
+            m_dictionary = DictionaryManager::instance()->dictionary(language);
+            updateCompletions();
+            validateAllBlocks();
+        }
+        else if (m_blockDictionaries.contains(language) && !m_blockDictionaries.value(language)) {
+            m_blockDictionaries.insert(language, DictionaryManager::instance()->dictionary(language));
+            validateAllBlocks();
+        }
+    });
     loadDictionary();
 
     connect(m_speakerCompleter, QOverload<const QString &>::of(&QCompleter::activated),
@@ -50,7 +77,14 @@ Editor::Editor(QWidget *parent)
     });
     m_saveTimer->start(m_saveInterval * 1000);
 
-    m_blocks.append(fromEditor(0));
+    m_transcript.appendBlock(fromEditor(0));
+}
+
+Editor::~Editor()
+{
+    // Tasks still running post their results to this editor
+    m_validationPool.clear();
+    m_validationPool.waitForDone();
 }
 
 void Editor::setEditorFont(const QFont& font)
@@ -64,84 +98,147 @@ void Editor::setEditorFont(const QFont& font)
 
 
 
-void Highlighter::highlightBlock(const QString& text)
+Highlighter::Highlighter(QTextDocument *parent)
+    : QSyntaxHighlighter(parent)
 {
-    if (invalidBlockNumbers.contains(currentBlock().blockNumber())) {
-        QTextCharFormat format;
-        format.setForeground(Qt::red);
-        setFormat(0, text.size(), format);
-        return;
+    m_invalidLineFormat.setForeground(Qt::red);
+
+    m_invalidWordFormat.setFontUnderline(true);
+    m_invalidWordFormat.setUnderlineColor(Qt::red);
+    m_invalidWordFormat.setUnderlineStyle(QTextCharFormat::SpellCheckUnderline);
+
+    m_unlikelyWordFormat.setFontUnderline(true);
+    m_unlikelyWordFormat.setUnderlineColor(QColor(Qt::blue).lighter(120));
+    m_unlikelyWordFormat.setUnderlineStyle(QTextCharFormat::DotLine);
+
+    m_speakerFormat.setForeground(QColor(Qt::blue).lighter(120));
+    m_textFormat.setForeground(Qt::green);
+    m_timeStampFormat.setForeground(Qt::red);
+
+    m_wordFormat.setFontUnderline(true);
+    m_wordFormat.setUnderlineColor(Qt::green);
+    m_wordFormat.setUnderlineStyle(QTextCharFormat::DashUnderline);
+    m_wordFormat.setForeground(Qt::green);
+}
+
+void Highlighter::setHighlight(int blockNumber, int wordNumber)
+{
+    auto previousBlock = blockToHighlight;
+    bool wordChanged = wordNumber != wordToHighlight;
+
+    blockToHighlight = blockNumber;
+    wordToHighlight = wordNumber;
+
+    if (m_linesMoved) {
+        m_linesMoved = false;
+        rehighlight();
     }
-    if (invalidWords.contains(currentBlock().blockNumber())) {
-        auto invalidWordNumbers = invalidWords.values(currentBlock().blockNumber());
-        auto speakerEnd = 0;
-        auto speakerMatch = QRegularExpression(R"(\[.*]:)").match(text);
-        if (speakerMatch.hasMatch())
-            speakerEnd = speakerMatch.capturedEnd();
-
-        auto words = text.mid(speakerEnd + 1).split(" ");
-        int start = speakerEnd;
-
-        QTextCharFormat format;
-        format.setFontUnderline(true);
-        format.setUnderlineColor(Qt::red);
-        format.setUnderlineStyle(QTextCharFormat::SpellCheckUnderline);
-
-        for (int i = 0; i < words.size() - 1; i++) {
-            if (!invalidWordNumbers.contains(i))
-                continue;
-            for (int j = 0; j < i; j++) start += (words[j].size() + 1);
-            int count = words[i].size();
-            setFormat(start + 1, count, format);
-            start = speakerEnd;
-        }
+    else if (previousBlock != blockNumber) {
+        rehighlightBlockNumber(previousBlock);
+        rehighlightBlockNumber(blockNumber);
     }
-    if (blockToHighlight == -1)
+    else if (wordChanged)
+        rehighlightBlockNumber(blockNumber);
+}
+
+void Highlighter::rehighlightBlockNumber(int blockNumber)
+{
+    if (blockNumber == -1 || !document())
         return;
-    else if (currentBlock().blockNumber() == blockToHighlight) {
-        int speakerEnd = 0;
-        auto speakerMatch = QRegularExpression(R"(\[.*]:)").match(text);
-        if (speakerMatch.hasMatch())
-            speakerEnd = speakerMatch.capturedEnd();
 
-        int timeStampStart = QRegularExpression(R"(\[(\d?\d:)?[0-5]?\d:[0-5]?\d(\.\d\d?\d?)?])").match(text).capturedStart();
+    auto textBlock = document()->findBlockByNumber(blockNumber);
+    if (textBlock.isValid())
+        rehighlightBlock(textBlock);
+}
 
-        QTextCharFormat format;
+void Highlighter::buildSpans(BlockData* data, int length) const
+{
+    data->formatSpans.clear();
 
-        format.setForeground(QColor(Qt::blue).lighter(120));
-        setFormat(0, speakerEnd, format);
+    if (data->invalidTimeStamp)
+        data->formatSpans.append({0, length, m_invalidLineFormat});
+    else {
+        for (int i = 0; i < data->invalidWords.size() && i < data->wordCount(); i++)
+            if (data->invalidWords.testBit(i))
+                data->formatSpans.append({data->wordStarts[i], data->wordLengths[i], m_invalidWordFormat});
+        for (int i = 0; i < data->unlikelyWords.size() && i < data->wordCount(); i++)
+            if (data->unlikelyWords.testBit(i))
+                data->formatSpans.append({data->wordStarts[i], data->wordLengths[i], m_unlikelyWordFormat});
+    }
 
-        format.setForeground(Qt::green);
-        setFormat(speakerEnd, timeStampStart, format);
+    data->spanRevision = data->tokenRevision;
+}
 
-        format.setForeground(Qt::red);
-        setFormat(timeStampStart, text.size(), format);
+void Highlighter::highlightBlock(const QString& text)
+{
+    auto data = BlockData::tokenized(currentBlock());
 
-        auto words = text.mid(speakerEnd + 1).split(" ");
+    if (data->spanRevision != data->tokenRevision)
+        buildSpans(data, text.size());
 
-        if (wordToHighlight != -1 && wordToHighlight < words.size()) {
-            int start = speakerEnd;
-            for (int i=0; i < wordToHighlight; i++) start += (words[i].size() + 1);
-            int count = words[wordToHighlight].size();
+    for (const auto& span: qAsConst(data->formatSpans))
+        setFormat(span.start, span.length, span.format);
 
-            format.setFontUnderline(true);
-            format.setUnderlineColor(Qt::green);
-            format.setUnderlineStyle(QTextCharFormat::DashUnderline);
-            format.setForeground(Qt::green);
-            setFormat(start + 1, count, format);
-        }
-    }
+    if (blockToHighlight == -1 || data->invalidTimeStamp || currentBlock().blockNumber() != blockToHighlight)
+        return;
+
+    int speakerEnd = data->parsedLine.speakerEnd();
+    int timeStampStart = data->parsedLine.timeStampStart;
+    if (timeStampStart == -1)
+        timeStampStart = text.size();
+
+    setFormat(0, speakerEnd, m_speakerFormat);
+    setFormat(speakerEnd, timeStampStart - speakerEnd, m_textFormat);
+    setFormat(timeStampStart, text.size() - timeStampStart, m_timeStampFormat);
+
+    if (wordToHighlight != -1 && wordToHighlight < data->wordCount())
+        setFormat(data->wordStarts[wordToHighlight], data->wordLengths[wordToHighlight], m_wordFormat);
 }
 
 void Editor::mousePressEvent(QMouseEvent *e)
 {
     QPlainTextEdit::mousePressEvent(e);
-    if (e->modifiers() == Qt::ControlModifier && !m_blocks.isEmpty())
+    if (e->modifiers() == Qt::ControlModifier && !m_transcript.isEmpty())
         helpJumpToPlayer();
 }
 
+bool Editor::viewportEvent(QEvent *event)
+{
+    // Lines marked invalid explain what is wrong with their time stamp on hover, and words marked
+    // unlikely why they are
+    if (event->type() == QEvent::ToolTip) {
+        auto helpEvent = static_cast<QHelpEvent*>(event);
+        auto cursor = cursorForPosition(helpEvent->pos());
+        auto textBlock = cursor.block();
+        auto data = static_cast<BlockData*>(textBlock.userData());
+        auto wordNumber = data ? BlockData::tokenized(textBlock)->wordAt(cursor.positionInBlock()) : -1;
+
+        if (data && data->invalidTimeStamp) {
+            auto& parsedLine = BlockData::tokenized(textBlock)->parsedLine;
+            auto message = parsedLine.error != ParsedLine::NoError ? LineParser::errorString(parsedLine)
+                                                                   : tr("Invalid time stamp");
+            QToolTip::showText(helpEvent->globalPos(), message, viewport());
+        }
+        else if (wordNumber != -1 && wordNumber < data->unlikelyWords.size() && data->unlikelyWords.testBit(wordNumber))
+            QToolTip::showText(helpEvent->globalPos(), tr("Rarely seen next to the words around it"), viewport());
+        else
+            QToolTip::hideText();
+        return true;
+    }
+    return TextEditor::viewportEvent(event);
+}
+
 void Editor::keyPressEvent(QKeyEvent *event)
 {
+    if (event->matches(QKeySequence::Undo)) {
+        undo();
+        return;
+    }
+    else if (event->matches(QKeySequence::Redo)) {
+        redo();
+        return;
+    }
+
     if (event->modifiers() == Qt::ControlModifier && event->key() == Qt::Key_R)
         createChangeSpeakerDialog();
     else if (event->modifiers() == Qt::ControlModifier && event->key() == Qt::Key_T)
@@ -174,6 +271,7 @@ void Editor::keyPressEvent(QKeyEvent *event)
     QString blockText = textCursor().block().text();
     QString textTillCursor = blockText.left(textCursor().positionInBlock());
     QString completionPrefix;
+    QStringList predictions;
 
     const bool shortcutPressed = (event->key() == Qt::Key_N && event->modifiers() == Qt::ControlModifier);
     const bool hasModifier = (event->modifiers() != Qt::NoModifier);
@@ -190,7 +288,7 @@ void Editor::keyPressEvent(QKeyEvent *event)
 
     QCompleter *m_completer = nullptr;
 
-    if (!textTillCursor.count(" ") && !textTillCursor.contains("]:") && !textTillCursor.contains("]")
+    if (!textTillCursor.contains(" ") && !textTillCursor.contains("]:") && !textTillCursor.contains("]")
             && textTillCursor.size() && containsSpeakerBraces) {
         // Complete speaker
         m_completer = m_speakerCompleter;
@@ -198,28 +296,29 @@ void Editor::keyPressEvent(QKeyEvent *event)
         completionPrefix = blockText.left(blockText.indexOf(" "));
         completionPrefix = completionPrefix.mid(1, completionPrefix.size() - 3);
 
-        QList<QString> speakers;
-        for (auto& a_block: qAsConst(m_blocks))
-            if (!speakers.contains(a_block.speaker) && a_block.speaker != "")
-                speakers.append(a_block.speaker);
-
-        m_speakerCompleter->setModel(new QStringListModel(speakers, m_speakerCompleter));
+        updateSpeakerModel();
     }
     else {
-        if (m_blocks[textCursor().blockNumber()].timeStamp.isValid()
-                && textTillCursor.count(" ") == blockText.count(" "))
+        auto data = BlockData::tokenized(textCursor().block());
+        auto positionInBlock = textCursor().positionInBlock();
+        if (data->parsedLine.timeStampStart != -1 && positionInBlock > data->parsedLine.timeStampStart)
             return;
 
-        int index = textTillCursor.count(" ");
-        completionPrefix = blockText.split(" ")[index];
+        auto wordNumber = data->wordAt(positionInBlock);
+        if (wordNumber != -1)
+            completionPrefix = data->wordText(blockText, wordNumber).toString();
 
-        if (completionPrefix.isEmpty()){
+        // Words likely after the ones before the cursor are offered before a word is begun
+        if (!m_transliterate)
+            predictions = predictedWords(textCursor().block(), positionInBlock, completionPrefix);
+
+        if (completionPrefix.isEmpty() && predictions.isEmpty()){
             m_textCompleter->popup()->hide();
             m_transliterationCompleter->popup()->hide();
             return;
         }
 
-        if (completionPrefix.size() < 2 && !m_transliterate) {
+        if (completionPrefix.size() < 2 && !m_transliterate && predictions.isEmpty()) {
             m_textCompleter->popup()->hide();
             return;
         }
@@ -253,6 +352,8 @@ void Editor::keyPressEvent(QKeyEvent *event)
     }
 
 
+    if (m_completer == m_textCompleter)
+        m_completionModel->setPrefix(completionPrefix, predictions);
     if (m_completer != m_transliterationCompleter && completionPrefix != m_completer->completionPrefix()) {
         m_completer->setCompletionPrefix(completionPrefix);
     }
@@ -268,27 +369,10 @@ void Editor::contextMenuEvent(QContextMenuEvent *event)
 {
     QMenu *menu = createStandardContextMenu();
 
-    QString blockText = textCursor().block().text();
-    QString textTillCursor = blockText.left(textCursor().positionInBlock());
-
-    const bool containsSpeakerBraces = blockText.leftRef(blockText.indexOf(" ")).contains("]:");
-    const bool containsTimeStamp = blockText.trimmed() != "" && blockText.trimmed().back() == ']';
-    bool isAWordUnderCursor = false;
-    int wordNumber;
-
-    if ((containsSpeakerBraces && textTillCursor.count(" ") > 0) || !containsSpeakerBraces) {
-        if (m_blocks.size() > textCursor().blockNumber() &&
-                !(containsTimeStamp && textTillCursor.count(" ") == blockText.count(" "))) {
-            isAWordUnderCursor = true;
-
-            if (containsSpeakerBraces) {
-                auto textWithoutSpeaker = textTillCursor.split("]:").last();
-                wordNumber = textWithoutSpeaker.trimmed().count(" ");
-            }
-            else
-                wordNumber = textTillCursor.trimmed().count(" ");
-        }
-    }
+    auto blockNumber = textCursor().blockNumber();
+    int wordNumber = BlockData::tokenized(textCursor().block())->wordAt(textCursor().positionInBlock());
+    const bool isAWordUnderCursor = blockNumber < m_transcript.blockCount()
+            && wordNumber != -1 && wordNumber < m_transcript.wordCount(blockNumber);
 
     if (isAWordUnderCursor) {
         auto markAsCorrectAction = new QAction;
@@ -300,6 +384,27 @@ void Editor::contextMenuEvent(QContextMenuEvent *event)
                     markWordAsCorrect(textCursor().blockNumber(), wordNumber);
         });
 
+        // Suggestions for a misspelt word replace it in place, keeping its time stamp and tags
+        auto dictionary = blockDictionary(blockNumber);
+        if (dictionary && !isWordCorrect(dictionary.data(), blockNumber, wordNumber)) {
+            auto key = m_transcript.wordKey(blockNumber, wordNumber);
+            auto suggestions = dictionary->suggestions.suggestions(dictionary->words, m_transcript.keyText(key), 5);
+
+            if (!suggestions.isEmpty()) {
+                auto firstAction = menu->actions().value(0);
+                for (auto& suggestion: qAsConst(suggestions)) {
+                    auto suggestionAction = new QAction(suggestion, menu);
+                    connect(suggestionAction, &QAction::triggered, this,
+                            [this, blockNumber, wordNumber, suggestion]()
+                            {
+                                replaceWord(blockNumber, wordNumber, suggestion);
+                    });
+                    menu->insertAction(firstAction, suggestionAction);
+                }
+                menu->insertSeparator(firstAction);
+            }
+        }
+
         menu->addAction(markAsCorrectAction);
     }
 
@@ -391,76 +496,51 @@ void Editor::transcriptClose()
 
     emit message("Closing file " + m_transcriptUrl.toLocalFile());
     m_transcriptUrl.clear();
-    m_blocks.clear();
+    m_transcript.clear();
     m_transcriptLang = "english";
     
     loadDictionary();
     clear();
+    updateInvalidWordCount();
 }
 
 void Editor::showBlocksFromData()
 {
-    for (auto& m_block: qAsConst(m_blocks)) {
-        qDebug() << m_block.timeStamp << m_block.speaker << m_block.text << m_block.tagList;
-        for (auto& m_word: qAsConst(m_block.words)) {
-            qDebug() << "   " << m_word.timeStamp << m_word.text << m_word.tagList;
+    for (int i = 0; i < m_transcript.blockCount(); i++) {
+        qDebug() << m_transcript.blockTime(i) << m_transcript.speaker(i) << m_transcript.blockText(i) << m_transcript.blockTags(i);
+        for (int j = 0; j < m_transcript.wordCount(i); j++) {
+            qDebug() << "   " << m_transcript.wordTime(i, j) << m_transcript.wordText(i, j) << m_transcript.wordTags(i, j);
         }
     }
 }
 
-void Editor::highlightTranscript(const QTime& elapsedTime)
+void Editor::highlightTranscript(qint64 elapsedTime)
 {
-    int blockToHighlight = -1;
-    int wordToHighlight = -1;
-
-    if (!m_blocks.isEmpty()) {
-        for (int i=0; i < m_blocks.size(); i++) {
-            if (m_blocks[i].timeStamp > elapsedTime) {
-                blockToHighlight = i;
-                break;
-            }
-        }
-    }
+    int blockToHighlight = m_transcript.blockAfter(elapsedTime);
+    int wordToHighlight = blockToHighlight == -1 ? -1 : m_transcript.wordAfter(blockToHighlight, elapsedTime);
 
-    if (blockToHighlight != highlightedBlock) {
+    if (blockToHighlight != highlightedBlock || wordToHighlight != highlightedWord) {
         highlightedBlock = blockToHighlight;
-        if (!m_highlighter)
-            m_highlighter = new Highlighter(document());
-        m_highlighter->setBlockToHighlight(blockToHighlight);
-    }
-
-    if (blockToHighlight == -1)
-        return;
-
-    for (int i = 0; i < m_blocks[blockToHighlight].words.size(); i++) {
-        if (m_blocks[blockToHighlight].words[i].timeStamp > elapsedTime) {
-            wordToHighlight = i;
-            break;
-        }
-    }
-
-    if (wordToHighlight != highlightedWord) {
         highlightedWord = wordToHighlight;
-        m_highlighter->setWordToHighlight(wordToHighlight);
+        m_highlighter->setHighlight(blockToHighlight, wordToHighlight);
     }
 }
 
-QTime Editor::getTime(const QString& text)
+word Editor::makeWord(qint64 t, const QString& s, const QStringList& tagList)
 {
-    if (text.contains(".")) {
-        if (text.count(":") == 2) return QTime::fromString(text, "h:m:s.z");
-        return QTime::fromString(text, "m:s.z");
-    }
-    else {
-        if (text.count(":") == 2) return QTime::fromString(text, "h:m:s");
-        return QTime::fromString(text, "m:s");
-    }
+    word w = {t, s, tagList};
+    return w;
 }
 
-word Editor::makeWord(const QTime& t, const QString& s, const QStringList& tagList)
+void Editor::updateSpeakerModel()
 {
-    word w = {t, s, tagList};
-    return w;
+    if (m_speakersRevision == m_transcript.speakersRevision())
+        return;
+
+    auto speakers = m_transcript.speakers();
+    speakers.removeAll("");
+    m_speakerModel->setStringList(speakers);
+    m_speakersRevision = m_transcript.speakersRevision();
 }
 
 QCompleter* Editor::makeCompleter()
@@ -476,40 +556,18 @@ QCompleter* Editor::makeCompleter()
 
 block Editor::fromEditor(qint64 blockNumber) const
 {
-    QTime timeStamp;
-    QVector<word> words;
-    QString text, speaker, blockText(document()->findBlockByNumber(blockNumber).text());
-
-    QRegularExpressionMatch match = timeStampExp.match(blockText);
-    if (match.hasMatch()) {
-        QString matchedTimeStampString = match.captured();
-        if (blockText.mid(match.capturedEnd()).trimmed() == "") {
-            // Get timestamp for string after removing the enclosing []
-            timeStamp = getTime(matchedTimeStampString.mid(1,matchedTimeStampString.size() - 2));
-            text = blockText.split(matchedTimeStampString)[0];
-        }
-    }
-
-    match = speakerExp.match(blockText);
-    if (match.hasMatch()) {
-        speaker = match.captured();
-        if (text != "")
-            text = text.split(speaker)[1];
-        speaker = speaker.left(speaker.size() - 2);
-        speaker = speaker.right(speaker.size() - 1);
-    }
-
-    if (text == "")
-        text = blockText.trimmed();
-    else
-        text = text.trimmed();
+    auto textBlock = document()->findBlockByNumber(blockNumber);
+    auto blockText = textBlock.text();
+    auto data = BlockData::tokenized(textBlock);
+    auto& parsedLine = data->parsedLine;
 
-    auto list = text.split(" ");
-    for (auto& m_word: qAsConst(list)) {
-        words.append(makeWord(QTime(), m_word, QStringList()));
-    }
+    QVector<word> words;
+    words.reserve(data->wordCount());
+    for (int i = 0; i < data->wordCount(); i++)
+        words.append(makeWord(TimeStamp::invalid, data->wordText(blockText, i).toString(), QStringList()));
 
-    block b = {timeStamp, text, speaker, QStringList(), words};
+    block b = {parsedLine.timeStamp, parsedLine.text(blockText).toString(), parsedLine.speaker(blockText).toString(),
+               QStringList(), words};
     return b;
 }
 
@@ -517,39 +575,35 @@ void Editor::loadTranscriptData(QFile& file)
 {
     QXmlStreamReader reader(&file);
     m_transcriptLang = "";
-    m_blocks.clear();
+    m_transcript.clear();
     if (reader.readNextStartElement()) {
         if (reader.name() == "transcript") {
             m_transcriptLang = reader.attributes().value("lang").toString();
 
             while(reader.readNextStartElement()) {
                 if(reader.name() == "line") {
-                    auto blockTimeStamp = getTime(reader.attributes().value("timestamp").toString());
-                    auto blockText = QString("");
+                    auto blockTimeStamp = TimeStamp::parse(reader.attributes().value("timestamp"));
                     auto blockSpeaker = reader.attributes().value("speaker").toString();
                     auto tagString = reader.attributes().value("tags").toString();
                     QStringList tagList;
                     if (tagString != "")
                         tagList = tagString.split(",");
 
-                    struct block line = {blockTimeStamp, "", blockSpeaker, tagList, QVector<word>()};
+                    auto line = m_transcript.appendBlock(blockTimeStamp, blockSpeaker, tagList);
                     while(reader.readNextStartElement()){
                         if(reader.name() == "word"){
-                            auto wordTimeStamp  = getTime(reader.attributes().value("timestamp").toString());
+                            auto wordTimeStamp  = TimeStamp::parse(reader.attributes().value("timestamp"));
                             auto wordTagString  = reader.attributes().value("tags").toString();
                             auto wordText       = reader.readElementText();
                             QStringList wordTagList;
                             if (wordTagString != "")
                                 wordTagList = wordTagString.split(",");
 
-                            blockText += (wordText + " ");
-                            line.words.append(makeWord(wordTimeStamp, wordText, wordTagList));
+                            m_transcript.appendWord(line, wordTimeStamp, wordText, wordTagList);
                         }
                         else
                             reader.skipCurrentElement();
                     }
-                    line.text = blockText.trimmed();
-                    m_blocks.append(line);
                 }
                 else
                     reader.skipCurrentElement();
@@ -570,27 +624,27 @@ void Editor::saveXml(QFile* file)
     if (m_transcriptLang != "")
         writer.writeAttribute("lang", m_transcriptLang);
 
-    for (auto& a_block: qAsConst(m_blocks)) {
-        if (a_block.text != "") {
-            auto timeStamp = a_block.timeStamp;
-            QString timeStampString = timeStamp.toString("hh:mm:ss.zzz");
-            auto speaker = a_block.speaker;
+    for (int i = 0; i < m_transcript.blockCount(); i++) {
+        if (m_transcript.blockText(i) != "") {
+            QString timeStampString = TimeStamp::format(m_transcript.blockTime(i));
 
             writer.writeStartElement("line");
             writer.writeAttribute("timestamp", timeStampString);
-            writer.writeAttribute("speaker", speaker);
+            writer.writeAttribute("speaker", m_transcript.speaker(i));
 
-            if (!a_block.tagList.isEmpty())
-                writer.writeAttribute("tags", a_block.tagList.join(","));
+            auto tagList = m_transcript.blockTags(i);
+            if (!tagList.isEmpty())
+                writer.writeAttribute("tags", tagList.join(","));
 
-            for (auto& a_word: qAsConst(a_block.words)) {
+            for (int j = 0; j < m_transcript.wordCount(i); j++) {
                 writer.writeStartElement("word");
-                writer.writeAttribute("timestamp", a_word.timeStamp.toString("hh:mm:ss.zzz"));
+                writer.writeAttribute("timestamp", TimeStamp::format(m_transcript.wordTime(i, j)));
 
-                if (!a_word.tagList.isEmpty())
-                    writer.writeAttribute("tags", a_word.tagList.join(","));
+                auto wordTagList = m_transcript.wordTags(i, j);
+                if (!wordTagList.isEmpty())
+                    writer.writeAttribute("tags", wordTagList.join(","));
 
-                writer.writeCharacters(a_word.text);
+                writer.writeCharacters(m_transcript.wordText(i, j).toString());
                 writer.writeEndElement();
             }
             writer.writeEndElement();
@@ -604,33 +658,28 @@ void Editor::saveXml(QFile* file)
 void Editor::helpJumpToPlayer()
 {
     auto currentBlockNumber = textCursor().blockNumber();
-    auto timeToJump = QTime(0, 0);
+    qint64 timeToJump = 0;
 
-    if (m_blocks[currentBlockNumber].timeStamp.isNull())
+    if (m_transcript.blockTime(currentBlockNumber) == TimeStamp::invalid)
         return;
 
-    int positionInBlock = textCursor().positionInBlock();
-    auto blockText = textCursor().block().text();
-    auto textBeforeCursor = blockText.left(positionInBlock);
-    int wordNumber = textBeforeCursor.count(" ");
-    if (m_blocks[currentBlockNumber].speaker != "" || textCursor().block().text().contains("[]:"))
-        wordNumber--;
+    int wordNumber = BlockData::tokenized(textCursor().block())->wordAt(textCursor().positionInBlock());
 
     for (int i = currentBlockNumber - 1; i >= 0; i--) {
-        if (m_blocks[i].timeStamp.isValid()) {
-            timeToJump = m_blocks[i].timeStamp;
+        if (m_transcript.blockTime(i) != TimeStamp::invalid) {
+            timeToJump = m_transcript.blockTime(i);
             break;
         }
     }
 
     // If we can jump to a word, then do so
     if (wordNumber >= 0 &&
-        wordNumber < m_blocks[currentBlockNumber].words.size() &&
-        m_blocks[currentBlockNumber].words[wordNumber].timeStamp.isValid()
+        wordNumber < m_transcript.wordCount(currentBlockNumber) &&
+        m_transcript.wordTime(currentBlockNumber, wordNumber) != TimeStamp::invalid
         ) {
         for (int i = wordNumber - 1; i >= 0; i--) {
-            if (m_blocks[currentBlockNumber].words[i].timeStamp.isValid()) {
-                timeToJump = m_blocks[currentBlockNumber].words[i].timeStamp;
+            if (m_transcript.wordTime(currentBlockNumber, i) != TimeStamp::invalid) {
+                timeToJump = m_transcript.wordTime(currentBlockNumber, i);
                 emit jumpToPlayer(timeToJump);
                 return;
             }
@@ -642,180 +691,292 @@ void Editor::helpJumpToPlayer()
 
 void Editor::loadDictionary()
 {
-    m_correctedWords.clear();
-    m_dictionary.clear();
+    // Null until the manager has loaded it, dictionaryReady then brings it in
+    m_dictionary = DictionaryManager::instance()->dictionary(m_transcriptLang);
+    m_blockDictionaries.clear();
+    m_correctedWords.load(m_transcriptLang);
 
-    auto dictionaryFileName = QString(":/wordlists/%1.txt").arg(m_transcriptLang);
-    m_dictionary = listFromFile(dictionaryFileName);
+    updateCompletions();
+    validateAllBlocks();
+}
 
-    auto correctedWordsList = listFromFile(QString("corrected_words_%1.txt").arg(m_transcriptLang));
-    if (!correctedWordsList.isEmpty()) {
-        std::copy(correctedWordsList.begin(),
-                  correctedWordsList.end(),
-                  std::inserter(m_correctedWords, m_correctedWords.begin()));
+void Editor::updateCompletions()
+{
+    auto correctedKeys = m_correctedWords.keys();
+    std::sort(correctedKeys.begin(), correctedKeys.end());
+    m_completionModel->setWords(m_dictionary, correctedKeys);
+}
 
-        for (auto& a_word: m_correctedWords) {
-            m_dictionary.insert
-            (
-                std::upper_bound(m_dictionary.begin(), m_dictionary.end(), a_word),
-                a_word
-            );
-        }
-    }
-    m_textCompleter->setModel(new QStringListModel(m_dictionary, m_textCompleter));
+void Editor::setContent()
+{
+    if (!settingContent) {
+        settingContent = true;
 
-    if (!m_highlighter)
-        return;
+        QString content("");
+        for (int i = 0; i < m_transcript.blockCount(); i++)
+            content.append(blockLine(i) + "\n");
 
-    QMultiMap<int, int> invalidWords;
-    for (int i = 0; i < m_blocks.size(); i++) {
-        for (int j = 0; j < m_blocks[i].words.size(); j++) {
-            auto wordText = m_blocks[i].words[j].text.toLower();
+        // Detach the highlighter so the new text is only highlighted once with its time stamps
+        // checked, the words are checked on the pool and their lines highlighted again as they come
+        m_highlighter->setDocument(nullptr);
+        setPlainText(content.trimmed());
+        m_transcript.clearChanges();
+
+        for (auto textBlock = document()->begin();
+             textBlock.isValid() && textBlock.blockNumber() < m_transcript.blockCount();
+             textBlock = textBlock.next()) {
+            auto blockNumber = textBlock.blockNumber();
+            setValidation(textBlock, m_transcript.blockId(blockNumber),
+                          m_transcript.blockTime(blockNumber) == TimeStamp::invalid, QBitArray(), QBitArray());
+        }
 
-            if (wordText != "" && m_punctuation.contains(wordText.back()))
-                wordText = wordText.left(wordText.size() - 1);
+        m_highlighter->setDocument(document());
+        updateInvalidWordCount();
 
-            if (!std::binary_search(m_dictionary.begin(),
-                                    m_dictionary.end(),
-                                    wordText)
-                )
-                invalidWords.insert(i, j);
-        }
+        settingContent = false;
+        validateAllBlocks();
     }
-    m_highlighter->setInvalidWords(invalidWords);
-    m_highlighter->rehighlight();
 }
 
-QStringList Editor::listFromFile(const QString& fileName)
+void Editor::syncDocument()
 {
-    QStringList words;
-
-    QFile file(fileName);
-    if (!file.open(QFile::ReadOnly))
-        return {};
+    if (settingContent || m_editDepth > 0 || !m_transcript.hasChanges())
+        return;
 
-    while (!file.atEnd()) {
-        QByteArray line = file.readLine();
-        if (!line.isEmpty())
-            words << QString::fromUtf8(line.trimmed());
-    }
+    settingContent = true;
 
-    return words;
-}
+    auto change = m_transcript.changes();
+    m_transcript.clearChanges();
 
-void Editor::setContent()
-{
-    if (!settingContent) {
-        settingContent = true;
+    int first = change.first;
+    int common = qMin(change.removed, change.added);
 
-        if (m_highlighter)
-            delete m_highlighter;
+    QTextCursor cursor(document());
+    cursor.beginEditBlock();
 
-        QString content("");
-        for (auto& a_block: qAsConst(m_blocks)) {
-            auto blockText = "[" + a_block.speaker + "]: " + a_block.text + " [" + a_block.timeStamp.toString("hh:mm:ss.zzz") + "]";
-            content.append(blockText + "\n");
+    // Rewrite the lines present before and after the change, skipping the ones that are unchanged
+    QVector<int> unchangedLines;
+    for (int i = first; i < first + common; i++) {
+        auto textBlock = document()->findBlockByNumber(i);
+        auto lineText = blockLine(i);
+        if (textBlock.text() == lineText) {
+            unchangedLines.append(i);
+            continue;
         }
-        setPlainText(content.trimmed());
 
-        m_highlighter = new Highlighter(document());
-
-        QList<int> invalidBlocks;
-        QMultiMap<int, int> invalidWords;
-        for (int i = 0; i < m_blocks.size(); i++) {
-            if (m_blocks[i].timeStamp.isNull())
-                invalidBlocks.append(i);
-            else {
-                for (int j = 0; j < m_blocks[i].words.size(); j++) {
-                    auto wordText = m_blocks[i].words[j].text.toLower();
-
-                    if (wordText != "" && m_punctuation.contains(wordText.back()))
-                        wordText = wordText.left(wordText.size() - 1);
-
-                    if (!std::binary_search(m_dictionary.begin(),
-                                            m_dictionary.end(),
-                                            wordText)
-                       )
-                        invalidWords.insert(i, j);
-                }
+        cursor.setPosition(textBlock.position());
+        cursor.movePosition(QTextCursor::EndOfBlock, QTextCursor::KeepAnchor);
+        cursor.insertText(lineText);
+    }
+
+    if (change.removed > common) {
+        auto firstRemoved = document()->findBlockByNumber(first + common);
+        auto lastRemoved = document()->findBlockByNumber(first + change.removed - 1);
+
+        if (first + common > 0) {
+            cursor.setPosition(firstRemoved.position() - 1);
+            cursor.setPosition(lastRemoved.position() + lastRemoved.length() - 1, QTextCursor::KeepAnchor);
+        }
+        else {
+            cursor.setPosition(firstRemoved.position());
+            cursor.setPosition(lastRemoved.next().isValid() ? lastRemoved.next().position()
+                                                            : lastRemoved.position() + lastRemoved.length() - 1,
+                               QTextCursor::KeepAnchor);
+        }
+        cursor.removeSelectedText();
+    }
+    else if (change.added > common) {
+        if (first + common > 0) {
+            auto previousBlock = document()->findBlockByNumber(first + common - 1);
+            cursor.setPosition(previousBlock.position() + previousBlock.length() - 1);
+            for (int i = first + common; i < first + change.added; i++) {
+                cursor.insertBlock();
+                cursor.insertText(blockLine(i));
             }
         }
+        else {
+            cursor.setPosition(0);
+            for (int i = first + common; i < first + change.added; i++) {
+                cursor.insertText(blockLine(i));
+                cursor.insertBlock();
+            }
+        }
+    }
 
-        m_highlighter->setInvalidBlocks(invalidBlocks);
-        m_highlighter->setInvalidWords(invalidWords);
-        m_highlighter->setBlockToHighlight(highlightedBlock);
-        m_highlighter->setWordToHighlight(highlightedWord);
-
-        settingContent = false;
+    // Validate before the edit block closes so the highlighter formats each changed line once, the
+    // neighbouring lines are included as removing a line can leave its id on one of them. Lines whose
+    // text wasn't rewritten, as when only their tags changed, are highlighted again after it. Every
+    // line validated here counts as edited, so a pass started before the change can't overwrite it
+    // with results from the dictionary of its old tags.
+    QVector<QTextBlock> rehighlighted;
+    for (auto textBlock = document()->findBlockByNumber(qMax(first - 1, 0));
+         textBlock.isValid() && textBlock.blockNumber() <= first + change.added;
+         textBlock = textBlock.next()) {
+        BlockData::edited(textBlock);
+        auto number = textBlock.blockNumber();
+        auto rewritten = number >= first && number < first + change.added && !unchangedLines.contains(number);
+        if (validateBlock(textBlock) && !rewritten)
+            rehighlighted.append(textBlock);
     }
+
+    cursor.endEditBlock();
+    for (auto& textBlock: qAsConst(rehighlighted))
+        m_highlighter->rehighlightBlock(textBlock);
+
+    settingContent = false;
+}
+
+QString Editor::blockLine(int blockNumber) const
+{
+    return "[" + m_transcript.speaker(blockNumber) + "]: " + m_transcript.blockText(blockNumber)
+            + " [" + TimeStamp::format(m_transcript.blockTime(blockNumber)) + "]";
 }
 
 void Editor::contentChanged(int position, int charsRemoved, int charsAdded)
 {
     // If chars aren't added or deleted then return
-    if (!(charsAdded || charsRemoved) || settingContent)
-        return;
-    else if (m_blocks.isEmpty()) { // If block data is empty (i.e. no file opened) just fill them from editor
-        for (int i = 0; i < document()->blockCount(); i++)
-            m_blocks.append(fromEditor(i));
+    if (!(charsAdded || charsRemoved))
         return;
-    }
 
-    delete m_highlighter;
-    m_highlighter = new Highlighter(this->document());
+    // Every changed line is counted, those rewritten by syncDocument() included, the tokens cached on
+    // them are stale whichever way the text changed
+    for (auto textBlock = document()->findBlock(position);
+         textBlock.isValid() && textBlock.position() <= position + charsAdded;
+         textBlock = textBlock.next())
+        BlockData::edited(textBlock);
+
+    if (settingContent)
+        return;
 
-    int currentBlockNumber = textCursor().blockNumber();
+    // The edit replaced the model lines [firstBlock, oldLastBlock] with the document lines [firstBlock, lastBlock]
+    auto firstBlock = document()->findBlock(position).blockNumber();
+    auto lastBlock = document()->findBlock(position + charsAdded).blockNumber();
+    if (firstBlock == -1)
+        firstBlock = blockCount() - 1;
+    if (lastBlock == -1)
+        lastBlock = blockCount() - 1;
+
+    auto blocksAdded = blockCount() - m_transcript.blockCount();
+    auto oldLastBlock = qBound(firstBlock - 1, lastBlock - blocksAdded, m_transcript.blockCount() - 1);
+
+    int oldCount = oldLastBlock - firstBlock + 1;
+    int newCount = lastBlock - firstBlock + 1;
+
+    // Resolve the edited document lines to their records through the id kept on each block,
+    // lines created by the edit carry no id and become new records
+    QHash<int, int> oldPositions;
+    for (int i = firstBlock; i <= oldLastBlock; i++)
+        oldPositions.insert(m_transcript.blockId(i), i);
+
+    // Single keystrokes on one line are undone together, a larger change such as a paste or a
+    // replace all is a step of its own
+    if (charsAdded + charsRemoved == 1)
+        m_transcript.beginCommand("Typing", true);
+    else
+        m_transcript.beginCommand("Edit");
+
+    QVector<int> ids;
+    QSet<int> claimed;
+    auto editedBlock = document()->findBlockByNumber(firstBlock);
+    for (int i = 0; i < newCount; i++, editedBlock = editedBlock.next()) {
+        auto data = static_cast<BlockData*>(editedBlock.userData());
+        auto id = data ? data->id : -1;
+        if (!oldPositions.contains(id) || claimed.contains(id))
+            id = -1;
+        else
+            claimed.insert(id);
+        ids.append(id);
+    }
 
-    if(m_blocks.size() != blockCount()) {
-        auto blocksChanged = m_blocks.size() - blockCount();
-        if (blocksChanged > 0) { // Blocks deleted
-            qInfo() << "[Lines Deleted]" << QString("%1 lines deleted").arg(QString::number(blocksChanged));
-            for (int i = 1; i <= blocksChanged; i++)
-                m_blocks.removeAt(currentBlockNumber + 1);
+    // A split or merged line keeps the id of the upper line, when that line is empty the text
+    // belongs to the record of the line below it
+    for (int i = 0; i < newCount; i++) {
+        if (ids[i] == -1)
+            continue;
+
+        if (i + 1 < newCount && ids[i + 1] == -1
+                && document()->findBlockByNumber(firstBlock + i).text().trimmed() == "") {
+            ids[i + 1] = ids[i];
+            ids[i] = -1;
+            continue;
         }
-        else { // Blocks added
-            qInfo() << "[Lines Inserted]" << QString("%1 lines inserted").arg(QString::number(-blocksChanged));
-            for (int i = 1; i <= -blocksChanged; i++) {
-                if (document()->findBlockByNumber(currentBlockNumber + blocksChanged).text().trimmed() == "")
-                    m_blocks.insert(currentBlockNumber + blocksChanged, fromEditor(currentBlockNumber - i));
-                else
-                    m_blocks.insert(currentBlockNumber + blocksChanged + 1, fromEditor(currentBlockNumber - i + 1));
-            }
+
+        auto below = oldPositions[ids[i]] + 1;
+        if (below <= oldLastBlock && m_transcript.blockText(below - 1) == ""
+                && !claimed.contains(m_transcript.blockId(below))) {
+            claimed.remove(ids[i]);
+            ids[i] = m_transcript.blockId(below);
+            claimed.insert(ids[i]);
         }
     }
-    
-    auto currentBlockFromEditor = fromEditor(currentBlockNumber);
-    auto& currentBlockFromData = m_blocks[currentBlockNumber];
+
+    // A change spanning many lines, such as a replace all, leaves most of them as they were
+    editedBlock = document()->findBlockByNumber(firstBlock);
+    for (int i = 0; i < newCount; i++, editedBlock = editedBlock.next()) {
+        if (ids[i] == -1)
+            ids[i] = m_transcript.createBlock(fromEditor(firstBlock + i));
+        else if (editedBlock.text() != blockLine(oldPositions[ids[i]]))
+            updateBlockFromEditor(oldPositions[ids[i]], fromEditor(firstBlock + i));
+    }
+    m_transcript.setBlockOrder(firstBlock, oldCount, ids);
+
+    if (oldCount > newCount)
+        qInfo() << "[Lines Deleted]" << QString("%1 lines deleted").arg(QString::number(oldCount - newCount));
+    else if (newCount > oldCount)
+        qInfo() << "[Lines Inserted]" << QString("%1 lines inserted").arg(QString::number(newCount - oldCount));
+
+    if (m_transcript.blockCount() != blockCount()) {
+        qWarning() << "[Model Out Of Sync]" << "rebuilding transcript from editor";
+        m_transcript.clear();
+        for (int i = 0; i < blockCount(); i++)
+            m_transcript.appendBlock(fromEditor(i));
+        firstBlock = 0;
+        lastBlock = blockCount() - 1;
+    }
+
+    m_transcript.endCommand();
+
+    // The highlighter reformats the changed range right after this slot
+    for (auto textBlock = document()->findBlockByNumber(firstBlock);
+         textBlock.isValid() && textBlock.blockNumber() <= lastBlock;
+         textBlock = textBlock.next())
+        validateBlock(textBlock);
+
+    m_transcript.clearChanges();
+    updateWordEditor();
+}
+
+void Editor::updateBlockFromEditor(int blockNumber, const block& blockFromEditor)
+{
+    auto currentBlockFromEditor = blockFromEditor;
+    auto currentBlockFromData = m_transcript.blockAt(blockNumber);
 
     if (currentBlockFromData.speaker != currentBlockFromEditor.speaker) {
         qInfo() << "[Speaker Changed]"
-                << QString("line number: %1").arg(QString::number(currentBlockNumber + 1))
+                << QString("line number: %1").arg(QString::number(blockNumber + 1))
                 << QString("initial: %1").arg(currentBlockFromData.speaker)
                 << QString("final: %1").arg(currentBlockFromEditor.speaker);
 
-        currentBlockFromData.speaker = currentBlockFromEditor.speaker;
+        m_transcript.setSpeaker(blockNumber, currentBlockFromEditor.speaker);
     }
 
     if (currentBlockFromData.timeStamp != currentBlockFromEditor.timeStamp) {
-        currentBlockFromData.timeStamp = currentBlockFromEditor.timeStamp;
+        m_transcript.setBlockTime(blockNumber, currentBlockFromEditor.timeStamp);
         qInfo() << "[TimeStamp Changed]"
-                << QString("line number: %1, %2").arg(QString::number(currentBlockNumber + 1), currentBlockFromEditor.timeStamp.toString("hh:mm:ss.zzz"));
+                << QString("line number: %1, %2").arg(QString::number(blockNumber + 1), TimeStamp::format(currentBlockFromEditor.timeStamp));
     }
 
     if (currentBlockFromData.text != currentBlockFromEditor.text) {
         qInfo() << "[Text Changed]"
-                << QString("line number: %1").arg(QString::number(currentBlockNumber + 1))
+                << QString("line number: %1").arg(QString::number(blockNumber + 1))
                 << QString("initial: %1").arg(currentBlockFromData.text)
                 << QString("final: %1").arg(currentBlockFromEditor.text);
 
-        currentBlockFromData.text = currentBlockFromEditor.text;
-        auto tagList = currentBlockFromData.tagList;
-
         auto& wordsFromEditor = currentBlockFromEditor.words;
         auto& wordsFromData = currentBlockFromData.words;
 
         int wordsDifference = wordsFromEditor.size() - wordsFromData.size();
-        int diffStart{-1}, diffEnd{-1};
+        int diffStart{-1};
 
         for (int i = 0; i < wordsFromEditor.size() && i < wordsFromData.size(); i++)
             if (wordsFromEditor[i].text != wordsFromData[i].text) {
@@ -844,37 +1005,278 @@ void Editor::contentChanged(int position, int charsRemoved, int charsAdded)
                     wordsFromEditor[i].timeStamp = wordsFromData[j].timeStamp;
         }
 
-        currentBlockFromData = currentBlockFromEditor;
-        currentBlockFromData.tagList = tagList;
+        m_transcript.setWords(blockNumber, wordsFromEditor);
     }
+}
 
-    m_highlighter->setBlockToHighlight(highlightedBlock);
-    m_highlighter->setWordToHighlight(highlightedWord);
+// Returns whether the line's validation state changed
+bool Editor::validateBlock(QTextBlock textBlock)
+{
+    auto blockNumber = textBlock.blockNumber();
+    if (blockNumber >= m_transcript.blockCount())
+        return false;
+
+    auto invalidTimeStamp = m_transcript.blockTime(blockNumber) == TimeStamp::invalid;
+    QBitArray invalidWords, unlikelyWords;
+
+    if (!invalidTimeStamp) {
+        auto dictionary = blockDictionary(blockNumber);
+        invalidWords.resize(m_transcript.wordCount(blockNumber));
+        for (int i = 0; i < invalidWords.size(); i++)
+            if (!isWordCorrect(dictionary.data(), blockNumber, i))
+                invalidWords.setBit(i);
+
+        // Only the edited line is scored again, words are only scored against the ones in their line
+        if (dictionary) {
+            QVector<QStringView> keys(invalidWords.size());
+            for (int i = 0; i < keys.size(); i++)
+                keys[i] = m_transcript.keyText(m_transcript.wordKey(blockNumber, i));
+            unlikelyWords = ValidationTask::findUnlikelyWords(dictionary->phrases, keys, invalidWords);
+        }
+    }
 
-    QList<int> invalidBlocks;
-    QMultiMap<int, int> invalidWords;
-    for (int i = 0; i < m_blocks.size(); i++) {
-        if (m_blocks[i].timeStamp.isNull())
-            invalidBlocks.append(i);
-        else {
-            for (int j = 0; j < m_blocks[i].words.size(); j++) {
-                auto wordText = m_blocks[i].words[j].text.toLower();
+    return setValidation(textBlock, m_transcript.blockId(blockNumber), invalidTimeStamp, invalidWords, unlikelyWords);
+}
 
-                if (wordText != "" && m_punctuation.contains(wordText.back()))
-                    wordText = wordText.left(wordText.size() - 1);
+// Stores a line's validation state, returns whether it changed
+bool Editor::setValidation(QTextBlock textBlock, int id, bool invalidTimeStamp, const QBitArray& invalidWords,
+                           const QBitArray& unlikelyWords)
+{
+    auto data = BlockData::tokenized(textBlock);
+    data->id = id;
+
+    // Ids put back in the order by an undo come without their count, it is set whatever changed
+    m_transcript.setInvalidWordCount(id, invalidWords.count(true));
+    updateInvalidWordCount();
+
+    if (invalidTimeStamp == data->invalidTimeStamp && invalidWords == data->invalidWords
+        && unlikelyWords == data->unlikelyWords)
+        return false;
+
+    data->invalidTimeStamp = invalidTimeStamp;
+    data->invalidWords = invalidWords;
+    data->unlikelyWords = unlikelyWords;
+    data->spanRevision = -1;
+    return true;
+}
 
-                if (!std::binary_search(m_dictionary.begin(),
-                                        m_dictionary.end(),
-                                        wordText)
-                    )
-                    invalidWords.insert(i, j);
-            }
+// The words are checked on the pool against a snapshot, the visible lines first, and each range's
+// lines are highlighted as its results come in. A new pass drops what is left of the last one.
+void Editor::validateAllBlocks()
+{
+    static constexpr int rangeSize = 512;
+
+    m_validationPool.clear();
+
+    auto snapshot = QSharedPointer<ValidationSnapshot>::create();
+    snapshot->transcript = m_transcript.keySnapshot();
+    snapshot->correctedKeys = m_correctedWords.keySet();
+    snapshot->generation = ++m_validationGeneration;
+
+    auto blockCount = snapshot->transcript.blockIds.size();
+
+    // Blocks share the few dictionaries there are, each one is resolved once per pass
+    QHash<QString, int> dictionaryIndexes;
+    snapshot->blockDictionaries.reserve(blockCount);
+    for (int i = 0; i < blockCount; i++) {
+        auto language = blockLanguage(i);
+        auto found = dictionaryIndexes.constFind(language);
+        if (found == dictionaryIndexes.constEnd()) {
+            found = dictionaryIndexes.insert(language, snapshot->dictionaries.size());
+            snapshot->dictionaries.append(blockDictionary(i));
         }
+        snapshot->blockDictionaries.append(found.value());
     }
-    m_highlighter->setInvalidBlocks(invalidBlocks);
-    m_highlighter->setInvalidWords(invalidWords);
 
-    updateWordEditor();
+    snapshot->revisions.reserve(blockCount);
+    for (auto textBlock = document()->begin();
+         textBlock.isValid() && snapshot->revisions.size() < blockCount;
+         textBlock = textBlock.next())
+        snapshot->revisions.append(BlockData::revisionOf(textBlock));
+
+    auto firstVisible = qBound(0, cursorForPosition(QPoint(0, 0)).blockNumber(), blockCount);
+    auto endVisible = qBound(firstVisible, cursorForPosition(QPoint(0, viewport()->height() - 1)).blockNumber() + 1,
+                             blockCount);
+
+    // The visible lines, then the ones below them and the ones above last
+    QVector<QPair<int, int>> ranges;
+    if (endVisible > firstVisible)
+        ranges.append({firstVisible, endVisible - firstVisible});
+    for (int first = endVisible; first < blockCount; first += rangeSize)
+        ranges.append({first, qMin(rangeSize, blockCount - first)});
+    for (int first = 0; first < firstVisible; first += rangeSize)
+        ranges.append({first, qMin(rangeSize, firstVisible - first)});
+
+    m_validationTasksLeft = ranges.size();
+
+    auto done = [this, snapshot](int first, const QVector<QBitArray>& invalidWords,
+                                 const QVector<QBitArray>& unlikelyWords) {
+        QMetaObject::invokeMethod(this, [this, snapshot, first, invalidWords, unlikelyWords]() {
+            applyValidation(*snapshot, first, invalidWords, unlikelyWords);
+        });
+    };
+    for (int i = 0; i < ranges.size(); i++)
+        m_validationPool.start(new ValidationTask(snapshot, ranges[i].first, ranges[i].second, done),
+                               ranges.size() - i);
+}
+
+void Editor::applyValidation(const ValidationSnapshot& snapshot, int first, const QVector<QBitArray>& invalidWords,
+                             const QVector<QBitArray>& unlikelyWords)
+{
+    if (snapshot.generation != m_validationGeneration)
+        return;
+    m_validationTasksLeft--;
+
+    for (int i = 0; i < invalidWords.size(); i++) {
+        auto index = first + i;
+        auto id = snapshot.transcript.blockIds[index];
+        auto blockNumber = m_transcript.blockNumber(id);
+        if (blockNumber == -1 || index >= snapshot.revisions.size())
+            continue;
+
+        // Lines edited since the snapshot were validated when they changed
+        auto textBlock = document()->findBlockByNumber(blockNumber);
+        if (!textBlock.isValid() || BlockData::revisionOf(textBlock) != snapshot.revisions[index])
+            continue;
+
+        auto invalidTimeStamp = m_transcript.blockTime(blockNumber) == TimeStamp::invalid;
+        if (setValidation(textBlock, id, invalidTimeStamp, invalidTimeStamp ? QBitArray() : invalidWords[i],
+                          invalidTimeStamp ? QBitArray() : unlikelyWords[i]))
+            m_highlighter->rehighlightBlock(textBlock);
+    }
+}
+
+void Editor::updateInvalidWordCount()
+{
+    auto count = m_transcript.invalidWordCount();
+    if (count != m_invalidWordCount) {
+        m_invalidWordCount = count;
+        emit invalidWordCountChanged(count);
+    }
+}
+
+// Selects the nearest misspelt word after the cursor, or before it, wrapping around at the ends of
+// the transcript. The lines in between are skipped through the transcript's counts, not scanned.
+void Editor::jumpToInvalidWord(bool forward)
+{
+    if (m_transcript.invalidWordCount() == 0) {
+        emit message("No misspelt words");
+        return;
+    }
+
+    auto cursor = textCursor();
+    auto textBlock = cursor.block();
+    auto position = (forward ? cursor.selectionEnd() : cursor.selectionStart()) - textBlock.position();
+
+    auto wordNumber = invalidWordIn(textBlock, forward, position);
+    if (wordNumber == -1) {
+        auto blockNumber = forward ? m_transcript.nextInvalidBlock(textBlock.blockNumber() + 1)
+                                   : m_transcript.previousInvalidBlock(textBlock.blockNumber() - 1);
+        if (blockNumber == -1)
+            blockNumber = forward ? m_transcript.nextInvalidBlock(0)
+                                  : m_transcript.previousInvalidBlock(m_transcript.blockCount() - 1);
+
+        textBlock = document()->findBlockByNumber(blockNumber);
+        if (!textBlock.isValid())
+            return;
+        wordNumber = invalidWordIn(textBlock, forward, forward ? -1 : textBlock.length());
+    }
+    if (wordNumber == -1)
+        return;
+
+    auto data = BlockData::tokenized(textBlock);
+    auto wordStart = textBlock.position() + data->wordStarts[wordNumber];
+    cursor.setPosition(wordStart);
+    cursor.setPosition(wordStart + data->wordLengths[wordNumber], QTextCursor::KeepAnchor);
+    setTextCursor(cursor);
+    centerCursor();
+}
+
+// The first misspelt word of the line starting after the position, or the last one starting before it
+int Editor::invalidWordIn(QTextBlock textBlock, bool forward, int positionInBlock)
+{
+    auto data = BlockData::tokenized(textBlock);
+    auto count = qMin(data->wordCount(), data->invalidWords.size());
+
+    for (int i = 0; i < count; i++) {
+        auto wordNumber = forward ? i : count - 1 - i;
+        auto start = data->wordStarts[wordNumber];
+        if (data->invalidWords.testBit(wordNumber) && (forward ? start > positionInBlock : start < positionInBlock))
+            return wordNumber;
+    }
+    return -1;
+}
+
+// The words of a block with Lang_ tags are checked against the languages of the tags, all of them
+// when there are several, the others against the transcript's language
+QString Editor::blockLanguage(int blockNumber) const
+{
+    QStringList languages;
+    for (auto& tag: m_transcript.blockTags(blockNumber)) {
+        if (!tag.startsWith("Lang_"))
+            continue;
+        auto language = TagSelectionDialog::languageName(tag.mid(5));
+        if (!language.isEmpty())
+            languages << language;
+    }
+
+    if (languages.isEmpty())
+        return m_transcriptLang;
+
+    languages.sort();
+    languages.removeDuplicates();
+    return languages.join('+');
+}
+
+// Null while the dictionary is loading, dictionaryReady then revalidates
+QSharedPointer<const LanguageDictionary> Editor::blockDictionary(int blockNumber)
+{
+    auto language = blockLanguage(blockNumber);
+    if (language == m_transcriptLang)
+        return m_dictionary;
+
+    auto found = m_blockDictionaries.constFind(language);
+    if (found != m_blockDictionaries.constEnd())
+        return found.value();
+
+    auto dictionary = DictionaryManager::instance()->dictionary(language);
+    m_blockDictionaries.insert(language, dictionary);
+    return dictionary;
+}
+
+// The likeliest words after the two before the cursor that start with the prefix, from the
+// block's language model. Empty while it loads or when the language has none.
+QStringList Editor::predictedWords(QTextBlock textBlock, int positionInBlock, const QString& prefix)
+{
+    auto dictionary = blockDictionary(textBlock.blockNumber());
+    if (!dictionary || dictionary->phrases.isEmpty())
+        return {};
+
+    auto data = BlockData::tokenized(textBlock);
+    auto blockText = textBlock.text();
+    QString context[2];
+    for (int i = 0, found = 0; i < data->wordCount() && found < 2; i++) {
+        auto wordNumber = data->wordCount() - 1 - i;
+        if (data->wordStarts[wordNumber] + data->wordLengths[wordNumber] >= positionInBlock)
+            continue;
+        context[1 - found++] = Dictionary::normalizedKey(data->wordText(blockText, wordNumber));
+    }
+
+    QStringList words;
+    for (auto& prediction: dictionary->phrases.predict(context[0], context[1], Dictionary::normalizedKey(prefix), 5))
+        words.append(prediction.word.toString());
+    return words;
+}
+
+bool Editor::isWordCorrect(const LanguageDictionary* dictionary, int blockNumber, int wordNumber) const
+{
+    // The transcript keeps each word's key, so checking it is a single probe
+    auto key = m_transcript.wordKey(blockNumber, wordNumber);
+    auto keyText = m_transcript.keyText(key);
+    auto keyHash = m_transcript.keyHash(key);
+
+    // Words aren't marked while the dictionary is still loading
+    return !dictionary || dictionary->words.contains(keyText, keyHash) || m_correctedWords.contains(keyText, keyHash);
 }
 
 void Editor::jumpToHighlightedLine()
@@ -885,7 +1287,7 @@ void Editor::jumpToHighlightedLine()
     setTextCursor(cursor);
 }
 
-void Editor::splitLine(const QTime& elapsedTime)
+void Editor::splitLine(qint64 elapsedTime)
 {
     auto cursor = textCursor();
     if (cursor.blockNumber() != highlightedBlock)
@@ -893,53 +1295,34 @@ void Editor::splitLine(const QTime& elapsedTime)
 
     int positionInBlock = cursor.positionInBlock();
     auto blockText = cursor.block().text();
-    auto textBeforeCursor = blockText.left(positionInBlock);
-    auto textAfterCursor = blockText.right(blockText.size() - positionInBlock);
-    auto cutWordLeft = textBeforeCursor.split(" ").last();
-    auto cutWordRight = textAfterCursor.split(" ").first();
-    int wordNumber = textBeforeCursor.count(" ");
-
-    if (m_blocks[highlightedBlock].speaker != "" || blockText.contains("[]:"))
-        wordNumber--;
-    if (wordNumber < 0 || wordNumber >= m_blocks[highlightedBlock].words.size())
-        return;
+    auto data = BlockData::tokenized(cursor.block());
 
-    if (textBeforeCursor.contains("]:"))
-        textBeforeCursor = textBeforeCursor.split("]:").last();
-    if (textAfterCursor.contains("["))
-        textAfterCursor = textAfterCursor.split("[").first();
+    int wordNumber = data->wordAt(positionInBlock);
+    if (wordNumber < 0 || wordNumber >= m_transcript.wordCount(highlightedBlock))
+        return;
 
-    auto timeStampOfCutWord = m_blocks[highlightedBlock].words[wordNumber].timeStamp;
-    auto tagsOfCutWord = m_blocks[highlightedBlock].words[wordNumber].tagList;
-    QVector<word> words;
-    int sizeOfWordsAfter = m_blocks[highlightedBlock].words.size() - wordNumber - 1;
-
-    if (cutWordRight != "")
-        words.append(makeWord(timeStampOfCutWord, cutWordRight, tagsOfCutWord));
-    for (int i = 0; i < sizeOfWordsAfter; i++) {
-        words.append(m_blocks[highlightedBlock].words[wordNumber + 1]);
-        m_blocks[highlightedBlock].words.removeAt(wordNumber + 1);
-    }
+    int wordStart = data->wordStarts[wordNumber];
+    auto cutWordLeft = blockText.mid(wordStart, positionInBlock - wordStart);
+    auto cutWordRight = blockText.mid(positionInBlock, wordStart + data->wordLengths[wordNumber] - positionInBlock);
 
+    // The cut word goes down whole when the cursor is before it and stays up whole when the cursor
+    // is after it, a word cut in two keeps its timestamp and tags on the lower half
+    beginEdit("Split Line");
     if (cutWordLeft == "")
-        m_blocks[highlightedBlock].words.removeAt(wordNumber);
+        m_transcript.splitBlock(highlightedBlock, wordNumber);
+    else if (cutWordRight == "") {
+        m_transcript.splitBlock(highlightedBlock, wordNumber + 1);
+        m_transcript.setWordTime(highlightedBlock, wordNumber, elapsedTime);
+    }
     else {
-        m_blocks[highlightedBlock].words[wordNumber].text = cutWordLeft;
-        m_blocks[highlightedBlock].words[wordNumber].timeStamp = elapsedTime;
+        auto tagsOfCutWord = m_transcript.wordTags(highlightedBlock, wordNumber);
+        m_transcript.splitBlock(highlightedBlock, wordNumber);
+        m_transcript.setWordText(highlightedBlock + 1, 0, cutWordRight);
+        m_transcript.appendWord(highlightedBlock, elapsedTime, cutWordLeft, tagsOfCutWord);
     }
 
-    block blockToInsert = {m_blocks[highlightedBlock].timeStamp,
-                           textAfterCursor.trimmed(),
-                           m_blocks[highlightedBlock].speaker,
-                           m_blocks[highlightedBlock].tagList,
-                           words};
-    m_blocks.insert(highlightedBlock + 1, blockToInsert);
-
-    m_blocks[highlightedBlock].text = textBeforeCursor.trimmed();
-    m_blocks[highlightedBlock].timeStamp = elapsedTime;
-
-    setContent();
-    updateWordEditor();
+    m_transcript.setBlockTime(highlightedBlock, elapsedTime);
+    endEdit();
 
     qInfo() << "[Line Split]"
             << QString("line number: %1").arg(QString::number(highlightedBlock + 1))
@@ -951,18 +1334,12 @@ void Editor::mergeUp()
     auto blockNumber = textCursor().blockNumber();
     auto previousBlockNumber = blockNumber - 1;
 
-    if (m_blocks.isEmpty() || blockNumber == 0 || m_blocks[blockNumber].speaker != m_blocks[previousBlockNumber].speaker)
+    if (m_transcript.isEmpty() || blockNumber == 0 || m_transcript.speaker(blockNumber) != m_transcript.speaker(previousBlockNumber))
         return;
 
-    auto currentWords = m_blocks[blockNumber].words;
-
-    m_blocks[previousBlockNumber].words.append(currentWords);                 // Add current words to previous block
-    m_blocks[previousBlockNumber].timeStamp = m_blocks[blockNumber].timeStamp;  // Update time stamp of previous block
-    m_blocks[previousBlockNumber].text.append(" " + m_blocks[blockNumber].text);// Append text to previous block
-
-    m_blocks.removeAt(blockNumber);
-    setContent();
-    updateWordEditor();
+    beginEdit("Merge Up");
+    m_transcript.mergeBlocks(previousBlockNumber);      // Previous block takes the current words and time stamp
+    endEdit();
 
     QTextCursor cursor(document()->findBlockByNumber(previousBlockNumber));
     setTextCursor(cursor);
@@ -970,7 +1347,7 @@ void Editor::mergeUp()
 
     qInfo() << "[Merge Up]"
             << QString("line number: %1, %2").arg(QString::number(previousBlockNumber + 1), QString::number(blockNumber + 1))
-            << QString("final line: %1, %2").arg(QString::number(previousBlockNumber + 1), m_blocks[previousBlockNumber].text);
+            << QString("final line: %1, %2").arg(QString::number(previousBlockNumber + 1), m_transcript.blockText(previousBlockNumber));
 }
 
 void Editor::mergeDown()
@@ -978,22 +1355,15 @@ void Editor::mergeDown()
     auto blockNumber = textCursor().blockNumber();
     auto nextBlockNumber = blockNumber + 1;
 
-    if (m_blocks.isEmpty() || blockNumber == m_blocks.size() - 1 || m_blocks[blockNumber].speaker != m_blocks[nextBlockNumber].speaker)
+    if (m_transcript.isEmpty() || blockNumber == m_transcript.blockCount() - 1 || m_transcript.speaker(blockNumber) != m_transcript.speaker(nextBlockNumber))
         return;
 
-    auto currentWords = m_blocks[blockNumber].words;
-
-    auto temp = m_blocks[nextBlockNumber].words;
-    m_blocks[nextBlockNumber].words = currentWords;
-    m_blocks[nextBlockNumber].words.append(temp);
+    auto nextBlockTags = m_transcript.blockTags(nextBlockNumber);
 
-    auto tempText = m_blocks[nextBlockNumber].text;
-    m_blocks[nextBlockNumber].text = m_blocks[blockNumber].text;
-    m_blocks[nextBlockNumber].text.append(" " + tempText);
-
-    m_blocks.removeAt(blockNumber);
-    setContent();
-    updateWordEditor();
+    beginEdit("Merge Down");
+    m_transcript.mergeBlocks(blockNumber);
+    m_transcript.setBlockTags(blockNumber, nextBlockTags);
+    endEdit();
 
     QTextCursor cursor(document()->findBlockByNumber(blockNumber));
     setTextCursor(cursor);
@@ -1001,24 +1371,21 @@ void Editor::mergeDown()
 
     qInfo() << "[Merge Down]"
             << QString("line number: %1, %2").arg(QString::number(blockNumber + 1), QString::number(nextBlockNumber + 1))
-            << QString("final line: %1, %2").arg(QString::number(blockNumber + 1), m_blocks[nextBlockNumber].text);
+            << QString("final line: %1, %2").arg(QString::number(blockNumber + 1), m_transcript.blockText(blockNumber));
 }
 
 void Editor::createChangeSpeakerDialog()
 {
-    if (m_blocks.isEmpty())
+    if (m_transcript.isEmpty())
         return;
 
     m_changeSpeaker = new ChangeSpeakerDialog(this);
     m_changeSpeaker->setModal(true);
     m_changeSpeaker->setAttribute(Qt::WA_DeleteOnClose);
 
-    QSet<QString> speakers;
-    for (auto& a_block: qAsConst(m_blocks))
-        speakers.insert(a_block.speaker);
-
-    m_changeSpeaker->addItems(speakers.values());
-    m_changeSpeaker->setCurrentSpeaker(m_blocks.at(textCursor().blockNumber()).speaker);
+    updateSpeakerModel();
+    m_changeSpeaker->setSpeakerModel(m_speakerModel);
+    m_changeSpeaker->setCurrentSpeaker(m_transcript.speaker(textCursor().blockNumber()));
 
     connect(m_changeSpeaker,
             &ChangeSpeakerDialog::accepted,
@@ -1032,7 +1399,7 @@ void Editor::createChangeSpeakerDialog()
 
 void Editor::createTimePropagationDialog()
 {
-    if (m_blocks.isEmpty())
+    if (m_transcript.isEmpty())
         return;
 
     m_propagateTime = new TimePropagationDialog(this);
@@ -1056,14 +1423,14 @@ void Editor::createTimePropagationDialog()
 
 void Editor::createTagSelectionDialog()
 {
-    if (m_blocks.isEmpty())
+    if (m_transcript.isEmpty())
         return;
 
     m_selectTag = new TagSelectionDialog(this);
     m_selectTag->setModal(true);
     m_selectTag->setAttribute(Qt::WA_DeleteOnClose);
 
-    m_selectTag->markExistingTags(m_blocks[textCursor().blockNumber()].tagList);
+    m_selectTag->markExistingTags(m_transcript.blockTags(textCursor().blockNumber()));
 
     connect(m_selectTag,
             &TagSelectionDialog::accepted,
@@ -1075,17 +1442,18 @@ void Editor::createTagSelectionDialog()
     m_selectTag->show();
 }
 
-void Editor::insertTimeStamp(const QTime& elapsedTime)
+void Editor::insertTimeStamp(qint64 elapsedTime)
 {
     auto blockNumber = textCursor().blockNumber();
 
-    if (m_blocks.size() <= blockNumber)
+    if (m_transcript.blockCount() <= blockNumber)
         return;
 
-    m_blocks[blockNumber].timeStamp = elapsedTime;
-
     dontUpdateWordEditor = true;
-    setContent();
+    beginEdit("Insert Time Stamp");
+    m_transcript.setBlockTime(blockNumber, elapsedTime);
+    endEdit();
+
     QTextCursor cursor(document()->findBlockByNumber(blockNumber));
     cursor.movePosition(QTextCursor::EndOfBlock);
     setTextCursor(cursor);
@@ -1093,7 +1461,7 @@ void Editor::insertTimeStamp(const QTime& elapsedTime)
     dontUpdateWordEditor = false;
 
     qInfo() << "[Inserted TimeStamp from Player]"
-            << QString("line number: %1, timestamp: %2").arg(QString::number(blockNumber), elapsedTime.toString("hh:mm:ss.zzz"));
+            << QString("line number: %1, timestamp: %2").arg(QString::number(blockNumber), TimeStamp::format(elapsedTime));
 
 }
 
@@ -1114,34 +1482,23 @@ void Editor::speakerWiseJump(const QString& jumpDirection)
         return;
     }
 
-    auto speakerName = m_blocks[blockNumber].speaker;
     int blockToJump{-1};
 
-    if (jumpDirection == "up") {
-        for (int i = blockNumber - 1; i >= 0; i--)
-            if (speakerName == m_blocks[i].speaker) {
-                blockToJump = i;
-                break;
-            }
-    }
-    else if (jumpDirection == "down") {
-        for (int i = blockNumber + 1; i < m_blocks.size(); i++)
-            if (speakerName == m_blocks[i].speaker) {
-                blockToJump = i;
-                break;
-            }
-    }
+    if (jumpDirection == "up")
+        blockToJump = m_transcript.previousSpeakerTurn(blockNumber);
+    else if (jumpDirection == "down")
+        blockToJump = m_transcript.nextSpeakerTurn(blockNumber);
 
     if (blockToJump == -1) {
         emit message("Couldn't find a block to jump");
         return;
     }
 
-    QTime timeToJump(0, 0);
+    qint64 timeToJump = 0;
 
     for (int i = blockToJump - 1; i >= 0; i--) {
-        if (m_blocks[i].timeStamp.isValid()) {
-            timeToJump = m_blocks[i].timeStamp;
+        if (m_transcript.blockTime(i) != TimeStamp::invalid) {
+            timeToJump = m_transcript.blockTime(i);
             break;
         }
     }
@@ -1158,8 +1515,7 @@ void Editor::wordWiseJump(const QString& jumpDirection)
         return;
     }
 
-    auto& highlightedBlockWords = m_blocks[highlightedBlock].words;
-    QTime timeToJump;
+    qint64 timeToJump = TimeStamp::invalid;
     int wordToJump{-1};
 
     if (jumpDirection == "left")
@@ -1167,34 +1523,34 @@ void Editor::wordWiseJump(const QString& jumpDirection)
     else if (jumpDirection == "right")
         wordToJump = wordNumber + 1;
 
-    if (wordToJump < 0 || wordToJump >= highlightedBlockWords.size()) {
+    if (wordToJump < 0 || wordToJump >= m_transcript.wordCount(highlightedBlock)) {
         emit message("Can't jump, end of block reached!", 2000);
         return;
     }
 
     if (jumpDirection == "left") {
         if (wordToJump == 0){
-            timeToJump = QTime(0, 0);
+            timeToJump = 0;
             for (int i = highlightedBlock - 1; i >= 0; i--) {
-                if (m_blocks[i].timeStamp.isValid()) {
-                    timeToJump = m_blocks[i].timeStamp;
+                if (m_transcript.blockTime(i) != TimeStamp::invalid) {
+                    timeToJump = m_transcript.blockTime(i);
                     break;
                 }
             }
         }
         else {
             for (int i = wordToJump - 1; i >= 0; i--)
-                if (highlightedBlockWords[i].timeStamp.isValid()) {
-                    timeToJump = highlightedBlockWords[i].timeStamp;
+                if (m_transcript.wordTime(highlightedBlock, i) != TimeStamp::invalid) {
+                    timeToJump = m_transcript.wordTime(highlightedBlock, i);
                     break;
                 }
         }
     }
     
     if (jumpDirection == "right")
-        timeToJump = highlightedBlockWords[wordToJump - 1].timeStamp;
+        timeToJump = m_transcript.wordTime(highlightedBlock, wordToJump - 1);
 
-    if (timeToJump.isNull()) {
+    if (timeToJump == TimeStamp::invalid) {
         emit message("Couldn't find a word to jump to");
         return;
     }
@@ -1218,19 +1574,19 @@ void Editor::blockWiseJump(const QString& jumpDirection)
     if (blockToJump == -1 || blockToJump == blockCount())
         return;
 
-    QTime timeToJump;
+    qint64 timeToJump = TimeStamp::invalid;
 
     if (jumpDirection == "up") {
-        timeToJump = QTime(0, 0);
+        timeToJump = 0;
         for (int i = blockToJump - 1; i >= 0; i--) {
-            if (m_blocks[i].timeStamp.isValid()) {
-                timeToJump = m_blocks[i].timeStamp;
+            if (m_transcript.blockTime(i) != TimeStamp::invalid) {
+                timeToJump = m_transcript.blockTime(i);
                 break;
             }
         }
     }
     else if (jumpDirection == "down")
-        timeToJump = m_blocks[highlightedBlock].timeStamp;
+        timeToJump = m_transcript.blockTime(highlightedBlock);
 
     emit jumpToPlayer(timeToJump);
 
@@ -1242,21 +1598,82 @@ void Editor::useTransliteration(bool value, const QString& langCode)
     m_transliterateLangCode = langCode;
 }
 
+void Editor::beginEdit(const QString& text)
+{
+    m_editDepth++;
+    m_transcript.beginCommand(text);
+}
+
+void Editor::endEdit()
+{
+    m_transcript.endCommand();
+    if (--m_editDepth > 0)
+        return;
+
+    syncDocument();
+    updateWordEditor();
+}
+
+void Editor::undo()
+{
+    if (!m_transcript.canUndo())
+        return;
+
+    auto text = m_transcript.undoText();
+    m_transcript.undo();
+    showHistoryStep();
+
+    qInfo() << "[Undo]" << text;
+}
+
+void Editor::redo()
+{
+    if (!m_transcript.canRedo())
+        return;
+
+    auto text = m_transcript.redoText();
+    m_transcript.redo();
+    showHistoryStep();
+
+    qInfo() << "[Redo]" << text;
+}
+
+// Brings the document up to an undone or redone step and puts the cursor on its first line
+void Editor::showHistoryStep()
+{
+    if (!m_transcript.hasChanges())
+        return;
+
+    auto blockNumber = qMin(m_transcript.changes().first, m_transcript.blockCount() - 1);
+
+    dontUpdateWordEditor = true;
+    syncDocument();
+    QTextCursor cursor(document()->findBlockByNumber(blockNumber));
+    setTextCursor(cursor);
+    centerCursor();
+    dontUpdateWordEditor = false;
+
+    updateWordEditor();
+    if (!m_transcript.isEmpty())
+        emit refreshTagList(m_transcript.blockTags(blockNumber));
+}
+
 void Editor::updateWordEditor()
 {
-    if (!m_wordEditor || dontUpdateWordEditor)
+    if (!m_wordEditor || dontUpdateWordEditor || settingContent || m_editDepth > 0)
         return;
 
     updatingWordEditor = true;
 
     auto blockNumber = textCursor().blockNumber();
 
-    if (blockNumber >= m_blocks.size()) {
+    if (blockNumber >= m_transcript.blockCount()) {
         m_wordEditor->clear();
+        updatingWordEditor = false;
         return;
     }
 
-    m_wordEditor->refreshWords(m_blocks[blockNumber].words);
+    m_wordEditor->refreshWords(m_transcript, blockNumber);
 
     updatingWordEditor = false;
 }
@@ -1265,29 +1682,19 @@ void Editor::wordEditorChanged()
 {
     auto editorBlockNumber = textCursor().blockNumber();
 
-    if (document()->isEmpty() || m_blocks.isEmpty())
-        m_blocks.append(fromEditor(0));
-
-    if (settingContent || updatingWordEditor || editorBlockNumber >= m_blocks.size())
-        return;
-
-    auto& block = m_blocks[editorBlockNumber];
-    if (block.words.isEmpty()) {
-        block.words = m_wordEditor->currentWords();
-        return;
+    if (m_transcript.isEmpty()) {
+        m_transcript.appendBlock(fromEditor(0));
+        m_transcript.clearChanges();
     }
 
-    auto& words = block.words;
-    words.clear();
-
-    QString blockText;
-    words = m_wordEditor->currentWords();
-    for (auto& a_word: words)
-        blockText += a_word.text + " ";
-    block.text = blockText.trimmed();
+    if (settingContent || updatingWordEditor || editorBlockNumber >= m_transcript.blockCount())
+        return;
 
     dontUpdateWordEditor = true;
-    setContent();
+    beginEdit("Edit Words");
+    m_transcript.setWords(editorBlockNumber, m_wordEditor->currentWords());
+    endEdit();
+
     QTextCursor cursor(document()->findBlockByNumber(editorBlockNumber));
     setTextCursor(cursor);
     centerCursor();
@@ -1296,21 +1703,18 @@ void Editor::wordEditorChanged()
 
 void Editor::changeSpeaker(const QString& newSpeaker, bool replaceAllOccurrences)
 {
-    if (m_blocks.isEmpty())
+    if (m_transcript.isEmpty())
         return;
     auto blockNumber = textCursor().blockNumber();
-    auto blockSpeaker = m_blocks[blockNumber].speaker;
+    auto blockSpeaker = m_transcript.speaker(blockNumber);
 
+    beginEdit("Change Speaker");
     if (!replaceAllOccurrences)
-        m_blocks[blockNumber].speaker = newSpeaker;
-    else {
-        for (auto& a_block: m_blocks){
-            if (a_block.speaker == blockSpeaker)
-                a_block.speaker = newSpeaker;
-        }
-    }
+        m_transcript.setSpeaker(blockNumber, newSpeaker);
+    else
+        m_transcript.renameSpeaker(blockSpeaker, newSpeaker);
+    endEdit();
 
-    setContent();
     QTextCursor cursor(document()->findBlockByNumber(blockNumber));
     setTextCursor(cursor);
     centerCursor();
@@ -1321,9 +1725,9 @@ void Editor::changeSpeaker(const QString& newSpeaker, bool replaceAllOccurrences
             << QString("final: %1").arg(newSpeaker);
 }
 
-void Editor::propagateTime(const QTime& time, int start, int end, bool negateTime)
+void Editor::propagateTime(qint64 time, int start, int end, bool negateTime)
 {
-    if (time.isNull()) {
+    if (time < 0) {
         QMessageBox errorBox(QMessageBox::Critical, "Error", "Invalid Time Selected", QMessageBox::Ok);
         errorBox.exec();
         return;
@@ -1334,40 +1738,40 @@ void Editor::propagateTime(const QTime& time, int start, int end, bool negateTim
         return;
     }
 
+    beginEdit("Propagate Time");
     for (int i = start - 1; i < end; i++) {
-        auto& currentTimeStamp = m_blocks[i].timeStamp;
-
-        if (currentTimeStamp.isNull())
-            currentTimeStamp = QTime(0, 0, 0);
-
-        int secondsToAdd = time.hour() * 3600 + time.minute() * 60 + time.second();
-        int msecondsToAdd = time.msec();
-
-        if (negateTime) {
-            secondsToAdd = -secondsToAdd;
-            msecondsToAdd = -msecondsToAdd;
-        }
+        auto currentTimeStamp = qMax(m_transcript.blockTime(i), qint64(0));
 
-        currentTimeStamp = currentTimeStamp.addMSecs(msecondsToAdd);
-        currentTimeStamp = currentTimeStamp.addSecs(secondsToAdd);
+        // Time stamps no longer wrap around, shifting back stops at the start of the media
+        currentTimeStamp = qMax(currentTimeStamp + (negateTime ? -time : time), qint64(0));
 
+        m_transcript.setBlockTime(i, currentTimeStamp);
     }
+    endEdit();
 
     int blockNumber = textCursor().blockNumber();
 
-    setContent();
     QTextCursor cursor(document()->findBlockByNumber(blockNumber));
     setTextCursor(cursor);
     centerCursor();
 
     qInfo() << "[Time propagated]"
             << QString("block range: %1 - %2").arg(QString::number(start), QString::number(end))
-            << QString("time: %1 %2").arg(negateTime? "-" : "+", time.toString("hh:mm:ss.zzz"));
+            << QString("time: %1 %2").arg(negateTime? "-" : "+", TimeStamp::format(time));
 }
 
 void Editor::selectTags(const QStringList& newTagList)
 {
-    m_blocks[textCursor().blockNumber()].tagList = newTagList;
+    auto language = blockLanguage(textCursor().blockNumber());
+
+    beginEdit("Select Tags");
+    m_transcript.setBlockTags(textCursor().blockNumber(), newTagList);
+    endEdit();
+
+    // The sync checked the line against its new languages, a full pass still running would bring in
+    // results for the old ones
+    if (m_validationTasksLeft > 0 && blockLanguage(textCursor().blockNumber()) != language)
+        validateAllBlocks();
 
     emit refreshTagList(newTagList);
 
@@ -1377,59 +1781,64 @@ void Editor::selectTags(const QStringList& newTagList)
 
 void Editor::markWordAsCorrect(int blockNumber, int wordNumber)
 {
-    auto textToInsert = m_blocks[blockNumber].words[wordNumber].text.toLower();
+    auto key = m_transcript.wordKey(blockNumber, wordNumber);
+    auto textToInsert = m_transcript.keyText(key).toString();
+    auto keyHash = m_transcript.keyHash(key);
 
     if (textToInsert.trimmed() == "")
         return;
 
-    if (std::binary_search(m_dictionary.begin(),
-           m_dictionary.end(),
-           textToInsert))
+    auto dictionary = blockDictionary(blockNumber);
+    if ((dictionary && dictionary->words.contains(textToInsert, keyHash))
+        || m_correctedWords.contains(textToInsert, keyHash))
     {
         emit message("Word is already correct.");
         return;
     }
 
-    m_dictionary.insert
-    (
-            std::upper_bound(m_dictionary.begin(), m_dictionary.end(), textToInsert),
-            textToInsert
-    );
-
-    static_cast<QStringListModel*>(m_textCompleter->model())->setStringList(m_dictionary);
-    m_correctedWords.insert(textToInsert);
-
-    QMultiMap<int, int> invalidWords;
-    for (int i = 0; i < m_blocks.size(); i++) {
-        for (int j = 0; j < m_blocks[i].words.size(); j++) {
-            auto wordText = m_blocks[i].words[j].text.toLower();
-
-            if (wordText != "" && m_punctuation.contains(wordText.back()))
-                wordText = wordText.left(wordText.size() - 1);
-
-            if (!std::binary_search(m_dictionary.begin(),
-                                    m_dictionary.end(),
-                                    wordText)
-                )
-                invalidWords.insert(i, j);
-        }
-    }
-    m_highlighter->setInvalidWords(invalidWords);
-    m_highlighter->rehighlight();
+    if (!m_correctedWords.append(textToInsert, keyHash))
+        emit message("Couldn't write corrected words to file.");
 
-    QFile correctedWords(QString("corrected_words_%1.txt").arg(m_transcriptLang));
+    m_completionModel->addWord(textToInsert);
 
-    if (!correctedWords.open(QFile::WriteOnly | QFile::Truncate))
-        emit message("Couldn't write corrected words to file.");
+    // Only the lines with the word can change, unless a full pass that doesn't know the word yet is
+    // still running
+    if (m_validationTasksLeft > 0)
+        validateAllBlocks();
     else {
-        for (auto& a_word: m_correctedWords)
-            correctedWords.write(QString(a_word + "\n").toStdString().c_str());
+        for (auto number: m_transcript.blocksWithKey(key)) {
+            auto textBlock = document()->findBlockByNumber(number);
+            if (validateBlock(textBlock))
+                m_highlighter->rehighlightBlock(textBlock);
+        }
     }
 
     qInfo() << "[Mark As Correct]"
             << QString("text: %1").arg(textToInsert);
 }
 
+void Editor::replaceWord(int blockNumber, int wordNumber, const QString& suggestion)
+{
+    if (blockNumber >= m_transcript.blockCount() || wordNumber >= m_transcript.wordCount(blockNumber))
+        return;
+
+    // Suggestions are keys, give them back the word's capital and trailing mark
+    auto wordText = m_transcript.wordText(blockNumber, wordNumber).toString();
+    auto replacement = suggestion;
+    if (!wordText.isEmpty() && !replacement.isEmpty() && wordText.front().isUpper())
+        replacement[0] = replacement[0].toUpper();
+    if (!wordText.isEmpty() && Dictionary::isPunctuation(wordText.back()))
+        replacement.append(wordText.back());
+
+    beginEdit("Replace Word");
+    m_transcript.setWordText(blockNumber, wordNumber, replacement);
+    endEdit();
+
+    qInfo() << "[Replace Word]"
+            << QString("line number: %1, word number: %2").arg(QString::number(blockNumber + 1), QString::number(wordNumber + 1))
+            << QString("%1 -> %2").arg(wordText, replacement);
+}
+
 void Editor::insertSpeakerCompletion(const QString& completion)
 {
     if (m_speakerCompleter->widget() != this)
@@ -1453,8 +1862,11 @@ void Editor::insertTextCompletion(const QString& completion)
     QTextCursor tc = textCursor();
     int extra = completion.length() - m_textCompleter->completionPrefix().length();
 
-    tc.movePosition(QTextCursor::Left);
-    tc.movePosition(QTextCursor::EndOfWord);
+    // A predicted word is inserted where the cursor is, there is no word to complete
+    if (!m_textCompleter->completionPrefix().isEmpty()) {
+        tc.movePosition(QTextCursor::Left);
+        tc.movePosition(QTextCursor::EndOfWord);
+    }
     tc.insertText(completion.right(extra));
 
     setTextCursor(tc);
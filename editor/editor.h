@@ -1,6 +1,13 @@
 #pragma once
 
-#include "blockandword.h"
+#include "transcript.h"
+#include "completionmodel.h"
+#include "dictionarymanager.h"
+#include "correctedwords.h"
+#include "validationtask.h"
+#include "blockdata.h"
+#include "lineparser.h"
+#include "timestamp.h"
 #include "texteditor.h"
 #include "wordeditor.h"
 #include "utilities/changespeakerdialog.h"
@@ -8,26 +15,35 @@
 #include "utilities/tagselectiondialog.h"
 
 #include <QXmlStreamReader>
-#include <QRegularExpression>
 #include <QSyntaxHighlighter>
 #include <QTextDocument>
+#include <QTextBlock>
 #include <QCompleter>
 #include <QAbstractItemModel>
+#include <QStringListModel>
 #include <qcompleter.h>
-#include <set>
 #include <QNetworkAccessManager>
 #include <QNetworkRequest>
 #include <QNetworkReply>
 #include <QTimer>
+#include <QThreadPool>
 
 class Highlighter;
 
 class Editor : public TextEditor
 {
     Q_OBJECT
+    // Checks the transcript and validation state behind the document
+    friend class TestEditor;
 
 public:
     explicit Editor(QWidget *parent = nullptr);
+    ~Editor() override;
+
+    // Changes made to the transcript between beginEdit() and endEdit() are one undo step, the
+    // document, validation and word editor are brought up to date once when the outermost edit ends
+    void beginEdit(const QString& text);
+    void endEdit();
 
     void setWordEditor(WordEditor* wordEditor)
     {
@@ -37,15 +53,15 @@ public:
 
     void setEditorFont(const QFont& font);
 
-    QRegularExpression timeStampExp, speakerExp;
-
 protected:
+    bool viewportEvent(QEvent *event) override;
     void mousePressEvent(QMouseEvent *e) override;
     void keyPressEvent(QKeyEvent *event) override;
     void contextMenuEvent(QContextMenuEvent *event) override;
 
 signals:
-    void jumpToPlayer(const QTime& time);
+    void jumpToPlayer(qint64 time);
+    void invalidWordCountChanged(int count);
     void refreshTagList(const QStringList& tagList);
     void replyCame();
 
@@ -54,17 +70,19 @@ public slots:
     void transcriptSave();
     void transcriptSaveAs();
     void transcriptClose();
-    void highlightTranscript(const QTime& elapsedTime);
+    void highlightTranscript(qint64 elapsedTime);
 
     void showBlocksFromData();
     void jumpToHighlightedLine();
-    void splitLine(const QTime& elapsedTime);
+    void nextInvalidWord() { jumpToInvalidWord(true); }
+    void previousInvalidWord() { jumpToInvalidWord(false); }
+    void splitLine(qint64 elapsedTime);
     void mergeUp();
     void mergeDown();
     void createChangeSpeakerDialog();
     void createTimePropagationDialog();
     void createTagSelectionDialog();
-    void insertTimeStamp(const QTime& elapsedTime);
+    void insertTimeStamp(qint64 elapsedTime);
     void changeTranscriptLang();
 
     void speakerWiseJump(const QString& jumpDirection);
@@ -74,6 +92,9 @@ public slots:
     void useTransliteration(bool value, const QString& langCode = "en");
     void useAutoSave(bool value) {m_autoSave = value;}
 
+    void undo();
+    void redo();
+
 private slots:
     void contentChanged(int position, int charsRemoved, int charsAdded);
     void wordEditorChanged();
@@ -81,9 +102,10 @@ private slots:
     void updateWordEditor();
 
     void changeSpeaker(const QString& newSpeaker, bool replaceAllOccurrences);
-    void propagateTime(const QTime& time, int start, int end, bool negateTime);
+    void propagateTime(qint64 time, int start, int end, bool negateTime);
     void selectTags(const QStringList& newTagList);
     void markWordAsCorrect(int blockNumber, int wordNumber);
+    void replaceWord(int blockNumber, int wordNumber, const QString& suggestion);
 
     void insertSpeakerCompletion(const QString& completion);
     void insertTextCompletion(const QString& completion);
@@ -93,24 +115,42 @@ private slots:
     void sendRequest(const QString& input, const QString& langCode);
 
 private:
-    static QTime getTime(const QString& text);
-    static word makeWord(const QTime& t, const QString& s, const QStringList& tagList);
+    static word makeWord(qint64 t, const QString& s, const QStringList& tagList);
     QCompleter* makeCompleter(); 
+    void updateSpeakerModel();
 
     void loadTranscriptData(QFile& file);
     void setContent();
+    void syncDocument();
+    void showHistoryStep();
+    QString blockLine(int blockNumber) const;
     void saveXml(QFile* file);
     void helpJumpToPlayer();
     void loadDictionary();
+    void updateCompletions();
+    void updateBlockFromEditor(int blockNumber, const block& blockFromEditor);
+    bool validateBlock(QTextBlock textBlock);
+    bool setValidation(QTextBlock textBlock, int id, bool invalidTimeStamp, const QBitArray& invalidWords,
+                       const QBitArray& unlikelyWords);
+    void validateAllBlocks();
+    void applyValidation(const ValidationSnapshot& snapshot, int first, const QVector<QBitArray>& invalidWords,
+                         const QVector<QBitArray>& unlikelyWords);
+    void updateInvalidWordCount();
+    void jumpToInvalidWord(bool forward);
+    static int invalidWordIn(QTextBlock textBlock, bool forward, int positionInBlock);
+    bool isWordCorrect(const LanguageDictionary* dictionary, int blockNumber, int wordNumber) const;
+    QString blockLanguage(int blockNumber) const;
+    QSharedPointer<const LanguageDictionary> blockDictionary(int blockNumber);
+    QStringList predictedWords(QTextBlock textBlock, int positionInBlock, const QString& prefix);
 
     block fromEditor(qint64 blockNumber) const;
-    static QStringList listFromFile(const QString& fileName) ;
 
     bool settingContent{false}, updatingWordEditor{false}, dontUpdateWordEditor{false};
+    int m_editDepth{0};
     bool m_transliterate{false}, m_autoSave{false};
 
-    QVector<block> m_blocks;
-    QString m_transcriptLang, m_punctuation{",.!;:"};
+    Transcript m_transcript;
+    QString m_transcriptLang;
     QUrl m_transcriptUrl;
     Highlighter* m_highlighter = nullptr;
     qint64 highlightedBlock = -1, highlightedWord = -1;
@@ -119,13 +159,24 @@ private:
     TimePropagationDialog* m_propagateTime = nullptr;
     TagSelectionDialog* m_selectTag = nullptr;
     QCompleter *m_speakerCompleter = nullptr, *m_textCompleter = nullptr, *m_transliterationCompleter = nullptr;
-    QStringList m_dictionary;
-    std::set<QString> m_correctedWords;
+    CompletionModel* m_completionModel = nullptr;
+    QStringListModel* m_speakerModel = nullptr;
+    int m_speakersRevision{-1};
+    QSharedPointer<const LanguageDictionary> m_dictionary;
+    // Dictionaries of the languages set on blocks with Lang_ tags, null while loading
+    QHash<QString, QSharedPointer<const LanguageDictionary>> m_blockDictionaries;
+    CorrectedWords m_correctedWords;
     QString m_transliterateLangCode;
     QStringList m_lastReplyList;
     QNetworkAccessManager m_manager;
     QNetworkReply* m_reply = nullptr;
     QTimer* m_saveTimer = nullptr;
+
+    // Full validation passes run on this pool, results of older passes are dropped
+    QThreadPool m_validationPool;
+    int m_validationGeneration{0};
+    int m_validationTasksLeft{0};
+    int m_invalidWordCount{0};
     int m_saveInterval{20};
 };
 
@@ -136,44 +187,24 @@ class Highlighter : public QSyntaxHighlighter
 {
     Q_OBJECT
 public:
-    explicit Highlighter(QTextDocument *parent = nullptr) : QSyntaxHighlighter(parent) {};
-
-    void clearHighlight()
-    {
-        blockToHighlight = -1;
-        wordToHighlight = -1;
-    }
-    void setBlockToHighlight(qint64 blockNumber)
-    {
-        blockToHighlight = blockNumber;
-        rehighlight();
-    }
-    void setWordToHighlight(int wordNumber)
-    {
-        wordToHighlight = wordNumber;
-        rehighlight();
-    }
-    void setInvalidBlocks(const QList<int>& invalidBlocks)
-    {
-        invalidBlockNumbers = invalidBlocks;
-        rehighlight();
-    }
-    void setInvalidWords(const QMultiMap<int, int>& invalidWordsMap)
-    {
-        invalidWords = invalidWordsMap;
-        rehighlight();
-    }
-    void clearInvalidBlocks()
-    {
-        invalidBlockNumbers.clear();
-    }
+    explicit Highlighter(QTextDocument *parent = nullptr);
 
+    void clearHighlight() { setHighlight(-1, -1); }
+    // Only the lines whose highlight changes are formatted again
+    void setHighlight(int blockNumber, int wordNumber);
+    // Lines were inserted or removed, the highlighted line may no longer be at its number
+    void linesMoved() { m_linesMoved = true; }
     void highlightBlock(const QString&) override;
 
 private:
+    void rehighlightBlockNumber(int blockNumber);
+    void buildSpans(BlockData* data, int length) const;
+
     int blockToHighlight{-1};
     int wordToHighlight{-1};
-    QList<int> invalidBlockNumbers;
-    QMultiMap<int, int> invalidWords;
+    bool m_linesMoved{false};
+
+    QTextCharFormat m_invalidLineFormat, m_invalidWordFormat, m_unlikelyWordFormat;
+    QTextCharFormat m_speakerFormat, m_textFormat, m_timeStampFormat, m_wordFormat;
 };
 
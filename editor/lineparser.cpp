@@ -0,0 +1,89 @@
+#include "lineparser.h"
+#include "timestamp.h"
+
+#include <QObject>
+
+ParsedLine LineParser::parse(QStringView line)
+{
+    ParsedLine parsedLine;
+
+    int end = line.size();
+    while (end > 0 && line[end - 1].isSpace())
+        end--;
+
+    // The time stamp is the bracketed part closing the line
+    int timeStart = -1;
+    if (end > 0 && line[end - 1] == QLatin1Char(']')) {
+        int open = end - 2;
+        while (open >= 0 && line[open] != QLatin1Char('['))
+            open--;
+
+        if (open < 0) {
+            parsedLine.error = ParsedLine::MalformedTimeStamp;
+            parsedLine.errorPosition = end - 1;
+        }
+        else {
+            int errorPosition = 0;
+            parsedLine.timeStamp = TimeStamp::parse(line.mid(open + 1, end - open - 2), errorPosition);
+
+            if (parsedLine.timeStamp != TimeStamp::invalid)
+                timeStart = open;
+            else {
+                parsedLine.error = ParsedLine::MalformedTimeStamp;
+                parsedLine.errorPosition = open + 1 + errorPosition;
+            }
+        }
+    }
+    else {
+        parsedLine.error = ParsedLine::MissingTimeStamp;
+        parsedLine.errorPosition = end;
+    }
+
+    // The speaker tag runs from the first '[' up to the last "]:" before the time stamp
+    int limit = timeStart == -1 ? end : timeStart;
+    int speakerOpen = -1, speakerClose = -1;
+    for (int i = 0; i < limit; i++) {
+        if (speakerOpen == -1) {
+            if (line[i] == QLatin1Char('['))
+                speakerOpen = i;
+        }
+        else if (line[i] == QLatin1Char(']') && i + 1 < line.size() && line[i + 1] == QLatin1Char(':'))
+            speakerClose = i;
+    }
+
+    if (speakerClose != -1) {
+        parsedLine.speakerStart = speakerOpen + 1;
+        parsedLine.speakerLength = speakerClose - speakerOpen - 1;
+    }
+
+    // Without a time stamp the whole line is kept as text so nothing typed is lost
+    int textStart = 0, textEnd = end;
+    if (timeStart != -1) {
+        textStart = speakerClose != -1 ? speakerClose + 2 : 0;
+        textEnd = timeStart;
+    }
+
+    while (textStart < textEnd && line[textStart].isSpace())
+        textStart++;
+    while (textEnd > textStart && line[textEnd - 1].isSpace())
+        textEnd--;
+
+    parsedLine.textStart = textStart;
+    parsedLine.textLength = textEnd - textStart;
+    parsedLine.timeStampStart = timeStart;
+    return parsedLine;
+}
+
+QString LineParser::errorString(const ParsedLine& parsedLine)
+{
+    auto column = QString::number(parsedLine.errorPosition + 1);
+
+    switch (parsedLine.error) {
+    case ParsedLine::MissingTimeStamp:
+        return QObject::tr("Missing time stamp at the end of the line (column %1)").arg(column);
+    case ParsedLine::MalformedTimeStamp:
+        return QObject::tr("Malformed time stamp at column %1").arg(column);
+    default:
+        return QString();
+    }
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <QString>
+#include <QStringView>
+
+// One editor line of the form "[speaker]: text [hh:mm:ss.zzz]", its parts
+// are given as offsets into the parsed line
+struct ParsedLine
+{
+    enum Error
+    {
+        NoError,
+        MissingTimeStamp,
+        MalformedTimeStamp
+    };
+
+    int speakerStart{-1};       // -1 when the line has no speaker tag
+    int speakerLength{0};
+    int textStart{0};
+    int textLength{0};
+    int timeStampStart{-1};     // offset of the time stamp's '[', -1 when it isn't well formed
+    qint64 timeStamp{-1};       // milliseconds, -1 when missing or invalid
+
+    Error error{NoError};
+    int errorPosition{-1};
+
+    QStringView speaker(QStringView line) const
+    {
+        return speakerStart == -1 ? QStringView() : line.mid(speakerStart, speakerLength);
+    }
+    QStringView text(QStringView line) const { return line.mid(textStart, textLength); }
+    int speakerEnd() const { return speakerStart == -1 ? 0 : speakerStart + speakerLength + 2; }
+};
+
+// Single pass parser for editor lines, it doesn't allocate
+class LineParser
+{
+public:
+    static ParsedLine parse(QStringView line);
+    static QString errorString(const ParsedLine& parsedLine);
+};
@@ -0,0 +1,326 @@
+#include "ngrammodel.h"
+#include "dictionary.h"
+
+#include <QHash>
+#include <QVarLengthArray>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+constexpr int NGramModel::maxEntries;
+constexpr float NGramModel::expectedPairs;
+constexpr int NGramModel::filterProbes;
+
+static const char magic[8] = {'A', 'S', 'R', 'N', 'G', 'R', 'M', '\0'};
+
+// A context not matched is backed off from with this weight, as in stupid backoff
+static constexpr float backoff = 0.4f;
+static constexpr float scoreSteps = 32.0f;
+
+static quint64 contextKey(int first, int second)
+{
+    return quint64(quint32(first + 1)) << 32 | quint32(second + 1);
+}
+
+static quint8 score(float probability)
+{
+    return quint8(qMin(255, qRound(-std::log10(probability) * scoreSteps)));
+}
+
+// The pair's key mixed by splitmix64, its halves give the probes of the filter
+quint64 NGramModel::filterHash(int first, int second)
+{
+    auto hash = contextKey(first, second) + 0x9e3779b97f4a7c15ull;
+    hash = (hash ^ (hash >> 30)) * 0xbf58476d1ce4e5b9ull;
+    hash = (hash ^ (hash >> 27)) * 0x94d049bb133111ebull;
+    return hash ^ (hash >> 31);
+}
+
+QByteArray NGramModel::build(const QVector<QStringList>& lines)
+{
+    QStringList words;
+    for (auto& line: lines)
+        words += line;
+    std::sort(words.begin(), words.end());
+    words.erase(std::unique(words.begin(), words.end()), words.end());
+
+    QHash<QString, int> wordIndexes;
+    for (int i = 0; i < words.size(); i++)
+        wordIndexes.insert(words[i], i);
+
+    // How often each word follows each context
+    QHash<quint64, QHash<int, int>> counts;
+    quint32 pairCount = 0;
+    for (auto& line: lines) {
+        QVector<int> indexes;
+        for (auto& word: line)
+            indexes.append(wordIndexes.value(word));
+
+        for (int i = 0; i < indexes.size(); i++) {
+            counts[contextKey(-1, -1)][indexes[i]]++;
+            if (i >= 1) {
+                counts[contextKey(-1, indexes[i - 1])][indexes[i]]++;
+                pairCount++;
+            }
+            if (i >= 2)
+                counts[contextKey(indexes[i - 2], indexes[i - 1])][indexes[i]]++;
+        }
+    }
+
+    auto contexts = counts.keys().toVector();
+    std::sort(contexts.begin(), contexts.end());
+
+    QVector<quint32> firstEntries{0}, entries;
+    QByteArray scores, wordScores(words.size(), char(255));
+    QVector<quint64> pairs;
+    for (auto context: qAsConst(contexts)) {
+        const auto& followers = counts[context];
+        QVector<QPair<int, int>> ranked;     // count negated, word
+        int total = 0;
+        for (auto it = followers.constBegin(); it != followers.constEnd(); ++it) {
+            ranked.append({-it.value(), it.key()});
+            total += it.value();
+            if (context >> 32 == 0 && context != 0)
+                pairs.append(filterHash(int(quint32(context)) - 1, it.key()));
+        }
+        std::sort(ranked.begin(), ranked.end());
+        if (context == 0) {
+            for (auto& entry: qAsConst(ranked))
+                wordScores[entry.second] = char(score(float(-entry.first) / total));
+        }
+        ranked.resize(qMin(ranked.size(), maxEntries));
+
+        for (auto& entry: qAsConst(ranked)) {
+            entries.append(quint32(entry.second));
+            scores.append(char(score(float(-entry.first) / total)));
+        }
+        firstEntries.append(quint32(entries.size()));
+    }
+
+    quint32 slotCount = 16;
+    while (slotCount < quint32(words.size()) * 2)
+        slotCount *= 2;
+
+    QVector<quint32> hashes, offsets{0};
+    QVector<qint32> slots(int(slotCount), -1);
+    for (int i = 0; i < words.size(); i++) {
+        auto hash = Dictionary::keyHash(words[i]);
+        hashes.append(hash);
+        offsets.append(offsets.last() + quint32(words[i].size()));
+
+        auto slot = hash & (slotCount - 1);
+        while (slots[int(slot)] != -1)
+            slot = (slot + 1) & (slotCount - 1);
+        slots[int(slot)] = i;
+    }
+
+    // About ten bits for each pair, a false positive lets an unlikely pair pass
+    auto filterSize = quint32(qMax(1, (pairs.size() * 10 + 63) / 64));
+    QVector<quint64> pairFilter(int(filterSize), 0);
+    auto filterBits = quint64(filterSize) * 64;
+    for (auto hash: qAsConst(pairs)) {
+        for (int i = 0; i < filterProbes; i++) {
+            auto bit = (quint32(hash) + i * (hash >> 32 | 1)) % filterBits;
+            pairFilter[int(bit / 64)] |= quint64(1) << (bit % 64);
+        }
+    }
+
+    Header header;
+    std::memcpy(header.magic, magic, sizeof(magic));
+    header.version = version;
+    header.wordCount = quint32(words.size());
+    header.slotCount = slotCount;
+    header.textSize = offsets.last();
+    header.contextCount = quint32(contexts.size());
+    header.entryCount = quint32(entries.size());
+    header.filterSize = filterSize;
+    header.pairCount = pairCount;
+
+    QByteArray data;
+    data.append(reinterpret_cast<const char*>(&header), sizeof(Header));
+    data.append(reinterpret_cast<const char*>(contexts.constData()), contexts.size() * 8);
+    data.append(reinterpret_cast<const char*>(pairFilter.constData()), pairFilter.size() * 8);
+    data.append(reinterpret_cast<const char*>(hashes.constData()), hashes.size() * 4);
+    data.append(reinterpret_cast<const char*>(offsets.constData()), offsets.size() * 4);
+    data.append(reinterpret_cast<const char*>(slots.constData()), slots.size() * 4);
+    data.append(reinterpret_cast<const char*>(firstEntries.constData()), firstEntries.size() * 4);
+    data.append(reinterpret_cast<const char*>(entries.constData()), entries.size() * 4);
+    for (auto& word: qAsConst(words))
+        data.append(reinterpret_cast<const char*>(word.constData()), word.size() * 2);
+    data.append(scores);
+    data.append(wordScores);
+    return data;
+}
+
+bool NGramModel::load(const QString& fileName)
+{
+    clear();
+
+    m_file.setFileName(fileName);
+    if (!m_file.open(QFile::ReadOnly))
+        return false;
+
+    // The contexts are read as 64 bit values
+    auto size = m_file.size();
+    auto data = m_file.map(0, size);
+    if (data && reinterpret_cast<quintptr>(data) % alignof(quint64) == 0 && attach(data, size))
+        return true;
+
+    if (data)
+        m_file.unmap(data);
+    m_file.seek(0);
+    auto contents = m_file.readAll();
+    m_file.close();
+    return setData(contents);
+}
+
+bool NGramModel::setData(const QByteArray& data)
+{
+    clear();
+    m_data = data;
+    if (attach(reinterpret_cast<const uchar*>(m_data.constData()), m_data.size()))
+        return true;
+
+    m_data.clear();
+    return false;
+}
+
+void NGramModel::clear()
+{
+    m_header = nullptr;
+    m_contexts = m_pairFilter = nullptr;
+    m_hashes = m_offsets = m_firstEntries = m_entries = nullptr;
+    m_slots = nullptr;
+    m_text = nullptr;
+    m_scores = m_wordScores = nullptr;
+    m_byteSize = 0;
+    m_data.clear();
+    if (m_file.isOpen())
+        m_file.close();
+}
+
+QVector<NGramModel::Prediction> NGramModel::predict(QStringView previous, QStringView last, QStringView prefix,
+                                                    int count) const
+{
+    if (isEmpty() || count <= 0)
+        return {};
+
+    auto previousIndex = previous.isEmpty() ? -1 : indexOf(previous);
+    auto lastIndex = last.isEmpty() ? -1 : indexOf(last);
+
+    // The longest context known first, a word keeps the best probability any of them gives it
+    QVarLengthArray<quint64, 3> contexts;
+    if (previousIndex != -1 && lastIndex != -1)
+        contexts.append(contextKey(previousIndex, lastIndex));
+    if (lastIndex != -1)
+        contexts.append(contextKey(-1, lastIndex));
+    contexts.append(contextKey(-1, -1));
+
+    QVarLengthArray<QPair<float, int>, 3 * maxEntries> candidates;
+    auto weight = 1.0f;
+    for (auto context: contexts) {
+        auto end = m_contexts + m_header->contextCount;
+        auto found = std::lower_bound(m_contexts, end, context);
+        if (found != end && *found == context) {
+            auto index = int(found - m_contexts);
+            for (auto entry = m_firstEntries[index]; entry < m_firstEntries[index + 1]; entry++) {
+                auto wordIndex = int(m_entries[entry]);
+                if (!word(wordIndex).startsWith(prefix) || word(wordIndex).size() == prefix.size())
+                    continue;
+
+                auto probability = weight * std::pow(10.0f, -m_scores[entry] / scoreSteps);
+                auto seen = std::find_if(candidates.begin(), candidates.end(), [wordIndex](const QPair<float, int>& candidate) {
+                    return candidate.second == wordIndex;
+                });
+                if (seen == candidates.end())
+                    candidates.append({probability, wordIndex});
+                else
+                    seen->first = qMax(seen->first, probability);
+            }
+        }
+        weight *= backoff;
+    }
+
+    auto kept = qMin(count, candidates.size());
+    std::partial_sort(candidates.begin(), candidates.begin() + kept, candidates.end(),
+                      [](const QPair<float, int>& a, const QPair<float, int>& b) { return a.first > b.first; });
+
+    QVector<Prediction> predictions;
+    predictions.reserve(kept);
+    for (int i = 0; i < kept; i++)
+        predictions.append({word(candidates[i].second), candidates[i].first});
+    return predictions;
+}
+
+bool NGramModel::isUnlikelyPair(QStringView first, QStringView second) const
+{
+    if (isEmpty())
+        return false;
+
+    auto firstIndex = indexOf(first);
+    auto secondIndex = indexOf(second);
+    if (firstIndex == -1 || secondIndex == -1)
+        return false;
+
+    auto scores = m_wordScores[firstIndex] + m_wordScores[secondIndex];
+    auto expected = m_header->pairCount * std::pow(10.0f, -scores / scoreSteps);
+    if (expected < expectedPairs)
+        return false;
+
+    auto hash = filterHash(firstIndex, secondIndex);
+    auto filterBits = quint64(m_header->filterSize) * 64;
+    for (int i = 0; i < filterProbes; i++) {
+        auto bit = (quint32(hash) + i * (hash >> 32 | 1)) % filterBits;
+        if (!(m_pairFilter[bit / 64] & quint64(1) << (bit % 64)))
+            return true;
+    }
+    return false;
+}
+
+int NGramModel::indexOf(QStringView word) const
+{
+    auto hash = Dictionary::keyHash(word);
+    auto mask = m_header->slotCount - 1;
+    for (auto slot = hash & mask; m_slots[slot] != -1; slot = (slot + 1) & mask) {
+        auto index = m_slots[slot];
+        if (m_hashes[index] == hash && this->word(index) == word)
+            return index;
+    }
+    return -1;
+}
+
+// Only the sizes are checked, a file written on a machine with the other byte
+// order fails on the version
+bool NGramModel::attach(const uchar* data, qint64 size)
+{
+    if (size < qint64(sizeof(Header)))
+        return false;
+
+    auto header = reinterpret_cast<const Header*>(data);
+    if (std::memcmp(header->magic, magic, sizeof(magic)) != 0 || header->version != version)
+        return false;
+
+    auto slotCount = header->slotCount;
+    if (slotCount == 0 || (slotCount & (slotCount - 1)) || header->wordCount >= slotCount || header->filterSize == 0)
+        return false;
+
+    auto tables = qint64(header->wordCount) * 2 + 1 + slotCount + qint64(header->contextCount) + 1
+                  + header->entryCount;
+    if (size != qint64(sizeof(Header)) + (qint64(header->contextCount) + header->filterSize) * 8 + tables * 4
+                + qint64(header->textSize) * 2 + header->entryCount + header->wordCount)
+        return false;
+
+    m_header = header;
+    m_contexts = reinterpret_cast<const quint64*>(data + sizeof(Header));
+    m_pairFilter = m_contexts + header->contextCount;
+    m_hashes = reinterpret_cast<const quint32*>(m_pairFilter + header->filterSize);
+    m_offsets = m_hashes + header->wordCount;
+    m_slots = reinterpret_cast<const qint32*>(m_offsets + header->wordCount + 1);
+    m_firstEntries = reinterpret_cast<const quint32*>(m_slots + slotCount);
+    m_entries = m_firstEntries + header->contextCount + 1;
+    m_text = reinterpret_cast<const QChar*>(m_entries + header->entryCount);
+    m_scores = reinterpret_cast<const quint8*>(m_text + header->textSize);
+    m_wordScores = m_scores + header->entryCount;
+    m_byteSize = size;
+    return true;
+}
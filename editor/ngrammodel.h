@@ -0,0 +1,111 @@
+#pragma once
+
+#include <QByteArray>
+#include <QFile>
+#include <QString>
+#include <QStringList>
+#include <QStringView>
+#include <QVector>
+
+// Which words follow which in corrected transcripts, in a precompiled format
+// used in place from a mapped file like CompiledDictionary. For each context of
+// one or two words the words seen after it are stored best first with their
+// probability quantized to a byte, so a prediction is a binary search for each
+// context and a read of the entries after it. Words are spelling keys.
+//
+// Every pair of words seen in a row is also kept in a Bloom filter, with each
+// word's own probability, so a pair that should have been seen often and never
+// was can be told from one that is merely rare.
+//
+// Layout, native byte order:
+//   Header
+//   quint64 contexts[contextCount]   (first word + 1) << 32 | (second word + 1), 0 for none, sorted
+//   quint64 pairFilter[filterSize]   bits of the pairs seen, keyed like the contexts
+//   quint32 hashes[wordCount]
+//   quint32 offsets[wordCount + 1]   word i is text[offsets[i], offsets[i + 1])
+//   qint32  slots[slotCount]         open addressing on the hash, -1 when empty
+//   quint32 firstEntries[contextCount + 1]
+//   quint32 entries[entryCount]      word indexes, best first within a context
+//   char16  text[]
+//   quint8  scores[entryCount]       -log10 of the probability in steps of 1/32
+//   quint8  wordScores[wordCount]    the same for each word on its own
+class NGramModel
+{
+public:
+    // Entries kept for a context, the rest are never predicted
+    static constexpr int maxEntries = 32;
+    // Times a pair must be expected from how common its words are before never having seen it counts
+    static constexpr float expectedPairs = 5.0f;
+
+    struct Prediction
+    {
+        QStringView word;
+        float probability;
+    };
+
+    NGramModel() = default;
+    NGramModel(const NGramModel&) = delete;
+    NGramModel& operator=(const NGramModel&) = delete;
+
+    // Each line is the keys of one transcript line's words
+    static QByteArray build(const QVector<QStringList>& lines);
+
+    // Maps the file, reading it instead when it can't be mapped. Returns false
+    // when the file is missing or isn't a model.
+    bool load(const QString& fileName);
+    bool setData(const QByteArray& data);
+    void clear();
+
+    bool isEmpty() const { return !m_header || m_header->contextCount == 0; }
+    qint64 byteSize() const { return m_byteSize; }
+
+    // The words most likely after previous and last, either may be empty, backing off to the
+    // words after last alone and then to the commonest ones. Only words starting with the
+    // prefix are listed.
+    QVector<Prediction> predict(QStringView previous, QStringView last, QStringView prefix, int count) const;
+
+    // Whether second is unlikely right after first: both words are common enough that the pair
+    // would have been seen at least expectedPairs times if they were independent, yet it never
+    // was. False when the model doesn't know either word.
+    bool isUnlikelyPair(QStringView first, QStringView second) const;
+
+private:
+    struct Header
+    {
+        char magic[8];
+        quint32 version;
+        quint32 wordCount;
+        quint32 slotCount;
+        quint32 textSize;
+        quint32 contextCount;
+        quint32 entryCount;
+        quint32 filterSize;
+        quint32 pairCount;      // pairs of words in a row in the transcripts
+    };
+
+    static constexpr quint32 version = 2;
+    static constexpr int filterProbes = 7;
+
+    bool attach(const uchar* data, qint64 size);
+    int indexOf(QStringView word) const;
+    static quint64 filterHash(int first, int second);
+    QStringView word(int index) const
+    {
+        return QStringView(m_text + m_offsets[index], int(m_offsets[index + 1] - m_offsets[index]));
+    }
+
+    QFile m_file;
+    QByteArray m_data;
+    qint64 m_byteSize{0};
+    const Header* m_header = nullptr;
+    const quint32* m_hashes = nullptr;
+    const quint32* m_offsets = nullptr;
+    const qint32* m_slots = nullptr;
+    const quint64* m_contexts = nullptr;
+    const quint64* m_pairFilter = nullptr;
+    const quint32* m_firstEntries = nullptr;
+    const quint32* m_entries = nullptr;
+    const QChar* m_text = nullptr;
+    const quint8* m_scores = nullptr;
+    const quint8* m_wordScores = nullptr;
+};
@@ -0,0 +1,158 @@
+#include "suggestionindex.h"
+
+#include <QVarLengthArray>
+#include <algorithm>
+
+constexpr int SuggestionIndex::maxDistance;
+constexpr int SuggestionIndex::prefixLength;
+
+// FNV-1a of the text without the characters at skip1 and skip2, no string is built
+static quint32 deleteHash(QStringView text, int skip1, int skip2)
+{
+    quint32 hash = 2166136261u;
+    for (int i = 0; i < text.size(); i++) {
+        if (i == skip1 || i == skip2)
+            continue;
+        hash ^= text[i].unicode();
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+template<typename Function>
+void SuggestionIndex::forEachDelete(QStringView key, Function function)
+{
+    // QStringView::left() doesn't clamp in Qt 5
+    auto prefix = key.left(qMin(prefixLength, int(key.size())));
+
+    function(deleteHash(prefix, -1, -1));
+    for (int i = 0; i < prefix.size(); i++) {
+        function(deleteHash(prefix, i, -1));
+        for (int j = i + 1; j < prefix.size(); j++)
+            function(deleteHash(prefix, i, j));
+    }
+}
+
+void SuggestionIndex::build(const CompiledDictionary& dictionary)
+{
+    clear();
+
+    // Only the start of a word is indexed, a stem at least that long is indexed once for all its forms
+    QStringList starts;
+    for (int index = 0; index < dictionary.size(); index++) {
+        auto key = dictionary.key(index).toString();
+        starts.clear();
+        for (auto ending: dictionary.endings(index)) {
+            auto start = (key + ending.toString()).left(prefixLength);
+            if (!starts.contains(start))
+                starts.append(start);
+        }
+
+        for (auto& text: qAsConst(starts))
+            forEachDelete(text, [this, index](quint32 hash) {
+                m_entries.append(quint64(hash) << 32 | quint32(index));
+            });
+    }
+
+    // Keys with repeated characters give the same delete more than once
+    std::sort(m_entries.begin(), m_entries.end());
+    m_entries.erase(std::unique(m_entries.begin(), m_entries.end()), m_entries.end());
+    m_entries.squeeze();
+}
+
+void SuggestionIndex::clear()
+{
+    m_entries.clear();
+}
+
+QStringList SuggestionIndex::suggestions(const CompiledDictionary& dictionary, QStringView key, int count) const
+{
+    if (m_entries.isEmpty() || key.isEmpty())
+        return {};
+
+    QVector<int> candidates;
+    forEachDelete(key, [this, &candidates](quint32 hash) {
+        auto first = std::lower_bound(m_entries.constBegin(), m_entries.constEnd(), quint64(hash) << 32);
+        for (auto it = first; it != m_entries.constEnd() && quint32(*it >> 32) == hash; ++it)
+            candidates.append(int(quint32(*it)));
+    });
+    std::sort(candidates.begin(), candidates.end());
+    candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+
+    // Hash collisions and prefix matches are weeded out by comparing the whole keys
+    struct Match
+    {
+        int distance;
+        int lengthDifference;
+        QString text;
+
+        bool operator<(const Match& other) const
+        {
+            if (distance != other.distance)
+                return distance < other.distance;
+            if (lengthDifference != other.lengthDifference)
+                return lengthDifference < other.lengthDifference;
+            return text < other.text;
+        }
+        bool operator==(const Match& other) const { return text == other.text; }
+    };
+
+    // A candidate stem's forms are compared one by one, two keys can spell the same word
+    QVector<Match> matches;
+    for (auto index: qAsConst(candidates)) {
+        auto stem = dictionary.key(index);
+        for (auto ending: dictionary.endings(index)) {
+            auto lengthDifference = qAbs(stem.size() + ending.size() - key.size());
+            if (stem.size() + ending.size() == 0 || lengthDifference > maxDistance)
+                continue;
+
+            auto text = stem.toString() + ending.toString();
+            auto editDistance = distance(key, text);
+            if (editDistance > 0 && editDistance <= maxDistance)
+                matches.append({editDistance, lengthDifference, text});
+        }
+    }
+    std::sort(matches.begin(), matches.end());
+    matches.erase(std::unique(matches.begin(), matches.end()), matches.end());
+
+    QStringList result;
+    for (int i = 0; i < qMin(count, matches.size()); i++)
+        result.append(matches[i].text);
+    return result;
+}
+
+int SuggestionIndex::distance(QStringView a, QStringView b)
+{
+    if (qAbs(a.size() - b.size()) > maxDistance)
+        return maxDistance + 1;
+
+    // Three rows of the optimal string alignment table, stopping once a whole row is past the limit
+    QVarLengthArray<int, 192> rows(3 * (b.size() + 1));
+    auto beforePrevious = rows.data();
+    auto previous = beforePrevious + b.size() + 1;
+    auto current = previous + b.size() + 1;
+    for (int j = 0; j <= b.size(); j++)
+        current[j] = j;
+
+    for (int i = 1; i <= a.size(); i++) {
+        auto spare = beforePrevious;
+        beforePrevious = previous;
+        previous = current;
+        current = spare;
+        current[0] = i;
+
+        auto rowMinimum = current[0];
+        for (int j = 1; j <= b.size(); j++) {
+            auto cost = a[i - 1] == b[j - 1] ? 0 : 1;
+            current[j] = qMin(qMin(previous[j] + 1, current[j - 1] + 1), previous[j - 1] + cost);
+            if (i > 1 && j > 1 && a[i - 1] == b[j - 2] && a[i - 2] == b[j - 1])
+                current[j] = qMin(current[j], beforePrevious[j - 2] + 1);
+            rowMinimum = qMin(rowMinimum, current[j]);
+        }
+
+        if (rowMinimum > maxDistance)
+            return maxDistance + 1;
+    }
+
+    return qMin(current[b.size()], maxDistance + 1);
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include "compileddictionary.h"
+
+#include <QStringList>
+#include <QStringView>
+#include <QVector>
+
+// Spelling suggestions by symmetric deletes: every key is indexed under the
+// strings left after deleting up to two characters from its first few, a
+// misspelt key then finds its candidates by looking up its own deletes and
+// only those are compared with it.
+//
+// A dictionary's keys are indexed rather than its words, a stem once for each
+// different start its forms have, and a candidate stem's forms are spelt out
+// only when it is compared. The index holds no text, it is given the
+// dictionary it was built from with each lookup.
+class SuggestionIndex
+{
+public:
+    static constexpr int maxDistance = 2;
+
+    void build(const CompiledDictionary& dictionary);
+    void clear();
+    qint64 byteSize() const { return m_entries.size() * qint64(sizeof(quint64)); }
+
+    // Words of the dictionary at most maxDistance edits away from the key, closest first
+    QStringList suggestions(const CompiledDictionary& dictionary, QStringView key, int count) const;
+
+    // Edits between a and b counting an adjacent transposition as one, or maxDistance + 1 when
+    // there are more than maxDistance
+    static int distance(QStringView a, QStringView b);
+
+private:
+    // Only this many leading characters are indexed, candidates are compared whole
+    static constexpr int prefixLength = 7;
+
+    template<typename Function>
+    static void forEachDelete(QStringView key, Function function);
+
+    QVector<quint64> m_entries;     // delete hash in the high half, key index in the low, sorted
+};
@@ -0,0 +1,51 @@
+#include "timestamp.h"
+
+constexpr qint64 TimeStamp::invalid;
+
+QString TimeStamp::format(qint64 msecs, bool withMSecs)
+{
+    QString text(formattedLength(msecs, withMSecs), Qt::Uninitialized);
+    write(msecs, text.data(), withMSecs);
+    return text;
+}
+
+int TimeStamp::formattedLength(qint64 msecs, bool withMSecs)
+{
+    if (msecs < 0)
+        return 0;
+
+    int hourDigits = 2;
+    for (auto hours = msecs / 3600000; hours >= 100; hours /= 10)
+        hourDigits++;
+
+    return hourDigits + (withMSecs ? 10 : 6);
+}
+
+QChar* TimeStamp::write(qint64 msecs, QChar* out, bool withMSecs)
+{
+    if (msecs < 0)
+        return out;
+
+    auto writeDigits = [&out](qint64 value, int digits) {
+        for (int i = digits - 1; i >= 0; i--, value /= 10)
+            out[i] = QChar(ushort('0' + value % 10));
+        out += digits;
+    };
+
+    auto hours = msecs / 3600000;
+    int hourDigits = 2;
+    for (auto rest = hours; rest >= 100; rest /= 10)
+        hourDigits++;
+
+    writeDigits(hours, hourDigits);
+    *out++ = QLatin1Char(':');
+    writeDigits(msecs / 60000 % 60, 2);
+    *out++ = QLatin1Char(':');
+    writeDigits(msecs / 1000 % 60, 2);
+
+    if (withMSecs) {
+        *out++ = QLatin1Char('.');
+        writeDigits(msecs % 1000, 3);
+    }
+    return out;
+}
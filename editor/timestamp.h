@@ -0,0 +1,106 @@
+#pragma once
+
+#include <QString>
+#include <QStringView>
+
+// Time stamps are kept as milliseconds, -1 standing for a missing one. Their
+// text form is "[h]h:mm:ss[.mmm]" with no upper limit on the hours, "m:ss" is
+// accepted as well. The fraction is read as a fraction of a second.
+class TimeStamp
+{
+public:
+    static constexpr qint64 invalid = -1;
+
+    static constexpr qint64 fromParts(qint64 hours, int minutes, int seconds, int msecs = 0)
+    {
+        return ((hours * 60 + minutes) * 60 + seconds) * 1000 + msecs;
+    }
+
+    // Returns invalid when the text isn't a time stamp, errorPosition is then
+    // the offset at which it stops being one
+    static constexpr qint64 parse(QStringView text, int& errorPosition);
+    static constexpr qint64 parse(QStringView text)
+    {
+        int errorPosition = 0;
+        return parse(text, errorPosition);
+    }
+
+    // "hh:mm:ss.zzz", an empty string for an invalid time stamp
+    static QString format(qint64 msecs, bool withMSecs = true);
+    static int formattedLength(qint64 msecs, bool withMSecs = true);
+    // Writes formattedLength() characters to out and returns the position after them
+    static QChar* write(qint64 msecs, QChar* out, bool withMSecs = true);
+
+private:
+    static constexpr int maxHourDigits = 7;
+
+    static constexpr bool isDigit(QChar c) { return c.unicode() >= '0' && c.unicode() <= '9'; }
+    static constexpr int digitValue(QChar c) { return c.unicode() - '0'; }
+};
+
+constexpr qint64 TimeStamp::parse(QStringView text, int& errorPosition)
+{
+    qint64 fields[3] = {0, 0, 0};
+    int fieldStarts[3] = {0, 0, 0};
+    int fieldCount = 0;
+    int i = 0;
+
+    // The first field may be the hours, the others have at most two digits
+    while (true) {
+        const int start = i;
+        const int maxDigits = fieldCount == 0 ? maxHourDigits : 2;
+        qint64 value = 0;
+        while (i < text.size() && i - start < maxDigits && isDigit(text[i]))
+            value = value * 10 + digitValue(text[i++]);
+
+        if (i == start) {
+            errorPosition = i;
+            return invalid;
+        }
+
+        fields[fieldCount] = value;
+        fieldStarts[fieldCount] = start;
+        fieldCount++;
+
+        if (fieldCount < 3 && i < text.size() && text[i] == QLatin1Char(':'))
+            i++;
+        else
+            break;
+    }
+
+    if (fieldCount < 2 || (fieldCount == 2 && fieldStarts[1] - fieldStarts[0] > 3)) {
+        errorPosition = fieldCount < 2 ? i : fieldStarts[0] + 2;
+        return invalid;
+    }
+
+    int fraction = 0;
+    if (i < text.size() && text[i] == QLatin1Char('.')) {
+        const int start = ++i;
+        int scale = 100;
+        while (i < text.size() && i - start < 3 && isDigit(text[i])) {
+            fraction += digitValue(text[i++]) * scale;
+            scale /= 10;
+        }
+
+        if (i == start) {
+            errorPosition = i;
+            return invalid;
+        }
+    }
+
+    if (i != text.size()) {
+        errorPosition = i;
+        return invalid;
+    }
+
+    const auto hours = fieldCount == 3 ? fields[0] : 0;
+    const auto minutes = fields[fieldCount - 2];
+    const auto seconds = fields[fieldCount - 1];
+
+    if (minutes > 59 || seconds > 59) {
+        errorPosition = fieldStarts[minutes > 59 ? fieldCount - 2 : fieldCount - 1];
+        return invalid;
+    }
+
+    return fromParts(hours, int(minutes), int(seconds), fraction);
+}
@@ -0,0 +1,973 @@
+#include "transcript.h"
+
+#include <algorithm>
+
+Transcript::Transcript()
+{
+    clear();
+}
+
+void Transcript::clear()
+{
+    m_records.clear();
+    m_inUse.clear();
+    m_freeIds.clear();
+    m_order.clear();
+    orderChanged();
+    m_wordTimes.clear();
+    m_wordOffsets.clear();
+    m_wordLengths.clear();
+    m_wordTags.clear();
+    m_wordKeys.clear();
+    m_arena.clear();
+    m_spellingKeys.clear();
+    m_keyBlocks.clear();
+
+    m_speakers.clear();
+    m_speakerIds.clear();
+    m_speakerBlocks.clear();
+    m_speakersRevision++;
+    m_tagSets = {QStringList()};
+    m_tagSetIds = {{QString(), 0}};
+
+    m_liveWords = m_liveChars = 0;
+    m_retainedWords = m_retainedChars = 0;
+
+    // An open command can't be undone past a clear, it is dropped when it ends
+    m_command = Command();
+    m_touched.clear();
+    m_discardCommand = m_commandDepth > 0;
+    clearHistory();
+    clearChanges();
+}
+
+int Transcript::blockId(int blockNumber) const
+{
+    if (blockNumber != m_lastBlockNumber) {
+        m_lastBlockId = m_order.at(blockNumber);
+        m_lastBlockNumber = blockNumber;
+    }
+    return m_lastBlockId;
+}
+
+qint64 Transcript::blockTime(int blockNumber) const
+{
+    return recordAt(blockNumber).timeStamp;
+}
+
+QString Transcript::speaker(int blockNumber) const
+{
+    return m_speakers[recordAt(blockNumber).speaker];
+}
+
+QStringList Transcript::blockTags(int blockNumber) const
+{
+    return m_tagSets[recordAt(blockNumber).tags];
+}
+
+QString Transcript::blockText(int blockNumber) const
+{
+    const auto& record = recordAt(blockNumber);
+
+    QString text;
+    for (int i = record.firstWord; i < record.firstWord + record.wordCount; i++) {
+        if (i != record.firstWord)
+            text.append(' ');
+        text.append(m_arena.constData() + m_wordOffsets[i], m_wordLengths[i]);
+    }
+    return text;
+}
+
+int Transcript::wordCount(int blockNumber) const
+{
+    return recordAt(blockNumber).wordCount;
+}
+
+// The returned view points into the arena and is invalidated by any mutation
+QStringView Transcript::wordText(int blockNumber, int wordNumber) const
+{
+    auto index = wordIndex(blockNumber, wordNumber);
+    return QStringView(m_arena.constData() + m_wordOffsets[index], m_wordLengths[index]);
+}
+
+int Transcript::wordKey(int blockNumber, int wordNumber) const
+{
+    return m_wordKeys[wordIndex(blockNumber, wordNumber)];
+}
+
+QVector<int> Transcript::blocksWithKey(int key) const
+{
+    QVector<int> blockNumbers;
+    if (key < 0 || key >= m_keyBlocks.size())
+        return blockNumbers;
+
+    for (auto id: m_keyBlocks[key]) {
+        auto blockNumber = m_order.positionOf(id);
+        if (blockNumber == -1)
+            continue;
+
+        const auto& record = m_records[id];
+        auto first = m_wordKeys.constBegin() + record.firstWord;
+        if (std::find(first, first + record.wordCount, key) != first + record.wordCount)
+            blockNumbers.append(blockNumber);
+    }
+
+    std::sort(blockNumbers.begin(), blockNumbers.end());
+    blockNumbers.erase(std::unique(blockNumbers.begin(), blockNumbers.end()), blockNumbers.end());
+    return blockNumbers;
+}
+
+Transcript::KeySnapshot Transcript::keySnapshot() const
+{
+    KeySnapshot snapshot;
+    snapshot.keys = m_spellingKeys;
+    snapshot.wordKeys = m_wordKeys;
+    snapshot.blockIds = m_order.toVector();
+
+    snapshot.firstWords.reserve(snapshot.blockIds.size());
+    snapshot.wordCounts.reserve(snapshot.blockIds.size());
+    for (auto id: qAsConst(snapshot.blockIds)) {
+        snapshot.firstWords.append(m_records[id].firstWord);
+        snapshot.wordCounts.append(m_records[id].wordCount);
+    }
+    return snapshot;
+}
+
+qint64 Transcript::wordTime(int blockNumber, int wordNumber) const
+{
+    return m_wordTimes[wordIndex(blockNumber, wordNumber)];
+}
+
+// A block's word times are contiguous, scanning them is cheaper than keeping an index
+int Transcript::wordAfter(int blockNumber, qint64 time) const
+{
+    const auto& record = recordAt(blockNumber);
+    auto times = m_wordTimes.constData() + record.firstWord;
+
+    for (int i = 0; i < record.wordCount; i++)
+        if (times[i] > time)
+            return i;
+    return -1;
+}
+
+QStringList Transcript::wordTags(int blockNumber, int wordNumber) const
+{
+    return m_tagSets[m_wordTags[wordIndex(blockNumber, wordNumber)]];
+}
+
+block Transcript::blockAt(int blockNumber) const
+{
+    block b = {blockTime(blockNumber), blockText(blockNumber), speaker(blockNumber),
+               blockTags(blockNumber), words(blockNumber)};
+    return b;
+}
+
+QVector<word> Transcript::words(int blockNumber) const
+{
+    QVector<word> blockWords;
+    blockWords.reserve(wordCount(blockNumber));
+
+    for (int i = 0; i < wordCount(blockNumber); i++)
+        blockWords.append(word {wordTime(blockNumber, i),
+                                wordText(blockNumber, i).toString(),
+                                wordTags(blockNumber, i)});
+    return blockWords;
+}
+
+QStringList Transcript::speakers() const
+{
+    QStringList speakerList;
+    for (int i = 0; i < m_speakers.size(); i++)
+        if (!m_speakerBlocks[i].isEmpty())
+            speakerList.append(m_speakers[i]);
+    return speakerList;
+}
+
+QVector<int> Transcript::speakerBlocks(const QString& speaker) const
+{
+    QVector<int> blockNumbers;
+    auto found = m_speakerIds.constFind(speaker);
+    if (found == m_speakerIds.constEnd())
+        return blockNumbers;
+
+    blockNumbers.reserve(m_speakerBlocks[found.value()].size());
+    for (auto id: m_speakerBlocks[found.value()])
+        blockNumbers.append(m_order.positionOf(id));
+    return blockNumbers;
+}
+
+// The block's place among its speaker's blocks is found by binary search, the next one is beside it
+int Transcript::speakerTurn(int blockNumber, int step) const
+{
+    auto speaker = recordAt(blockNumber).speaker;
+    const auto& ids = m_speakerBlocks[speaker];
+    auto index = speakerBlockIndex(speaker, blockNumber) + step;
+    return index >= 0 && index < ids.size() ? m_order.positionOf(ids[index]) : -1;
+}
+
+void Transcript::setBlockTime(int blockNumber, qint64 time)
+{
+    auto record = recordAt(blockNumber);
+    record.timeStamp = time;
+    setRecord(blockId(blockNumber), record);
+    markChanged(blockNumber, 1, 1);
+}
+
+void Transcript::setSpeaker(int blockNumber, const QString& speaker)
+{
+    auto record = recordAt(blockNumber);
+    record.speaker = internSpeaker(speaker);
+    setRecord(blockId(blockNumber), record);
+    markChanged(blockNumber, 1, 1);
+}
+
+void Transcript::renameSpeaker(const QString& speaker, const QString& newSpeaker)
+{
+    auto found = m_speakerIds.constFind(speaker);
+    if (found == m_speakerIds.constEnd() || speaker == newSpeaker)
+        return;
+    auto ids = m_speakerBlocks[found.value()];
+    auto newId = internSpeaker(newSpeaker);
+
+    m_deferSpeakerBlocks = true;
+    for (auto id: qAsConst(ids)) {
+        auto record = m_records[id];
+        record.speaker = newId;
+        setRecord(id, record);
+        markChanged(m_order.positionOf(id), 1, 1);
+    }
+    m_deferSpeakerBlocks = false;
+    rebuildSpeakerBlocks();
+}
+
+void Transcript::setBlockTags(int blockNumber, const QStringList& tagList)
+{
+    auto record = recordAt(blockNumber);
+    record.tags = internTags(tagList);
+    setRecord(blockId(blockNumber), record);
+    // The text stays the same, but a Lang_ tag changes what the words are checked against
+    markChanged(blockNumber, 1, 1);
+}
+
+void Transcript::setWordTime(int blockNumber, int wordNumber, qint64 time)
+{
+    auto record = recordAt(blockNumber);
+    record.firstWord = copyWords(record);
+    m_wordTimes[record.firstWord + wordNumber] = time;
+    setRecord(blockId(blockNumber), record);
+    maybeCompact();
+}
+
+void Transcript::setWords(int blockNumber, const QVector<word>& words)
+{
+    auto record = recordAt(blockNumber);
+    record.firstWord = m_wordTimes.size();
+    record.wordCount = words.size();
+    record.charCount = 0;
+
+    growWords(words.size());
+    for (int i = 0; i < words.size(); i++) {
+        writeWord(record.firstWord + i, words[i]);
+        record.charCount += words[i].text.size();
+    }
+
+    setRecord(blockId(blockNumber), record);
+    markChanged(blockNumber, 1, 1);
+    maybeCompact();
+}
+
+int Transcript::appendBlock(qint64 time, const QString& speaker, const QStringList& tagList)
+{
+    BlockRecord record = {time, internSpeaker(speaker), internTags(tagList), m_wordTimes.size(), 0, 0};
+    insertIds(m_order.size(), {allocateRecord(record)});
+    return m_order.size() - 1;
+}
+
+// text must not point into the arena, appending may reallocate it
+void Transcript::appendWord(int blockNumber, qint64 time, QStringView text, const QStringList& tagList)
+{
+    auto record = recordAt(blockNumber);
+
+    // Entries past the end of the range are unused when it ends the arrays, otherwise move it there
+    if (record.firstWord + record.wordCount != m_wordTimes.size())
+        record.firstWord = copyWords(record);
+
+    growWords(1);
+    writeWord(record.firstWord + record.wordCount, time, text, tagList);
+    record.wordCount++;
+    record.charCount += text.size();
+
+    setRecord(blockId(blockNumber), record);
+    markChanged(blockNumber, 1, 1);
+}
+
+void Transcript::insertBlock(int blockNumber, const block& b)
+{
+    insertIds(blockNumber, {createBlock(b)});
+}
+
+void Transcript::replaceBlock(int blockNumber, const block& b)
+{
+    auto record = recordAt(blockNumber);
+    record.timeStamp = b.timeStamp;
+    record.speaker = internSpeaker(b.speaker);
+    record.tags = internTags(b.tagList);
+    setRecord(blockId(blockNumber), record);
+
+    setWords(blockNumber, b.words);
+}
+
+void Transcript::removeBlock(int blockNumber)
+{
+    auto id = blockId(blockNumber);
+    removeIds(blockNumber, 1);
+    releaseRecord(id);
+
+    maybeCompact();
+}
+
+void Transcript::splitBlock(int blockNumber, int wordNumber)
+{
+    auto record = recordAt(blockNumber);
+    wordNumber = qBound(0, wordNumber, record.wordCount);
+
+    BlockRecord lower = {record.timeStamp, record.speaker, record.tags,
+                         record.firstWord + wordNumber, record.wordCount - wordNumber, 0};
+
+    // Count the characters of the shorter side only
+    if (lower.wordCount < wordNumber)
+        lower.charCount = charCount(lower.firstWord, lower.wordCount);
+    else
+        lower.charCount = record.charCount - charCount(record.firstWord, wordNumber);
+
+    record.wordCount = wordNumber;
+    record.charCount -= lower.charCount;
+
+    setRecord(blockId(blockNumber), record);
+    insertIds(blockNumber + 1, {allocateRecord(lower)});
+    markChanged(blockNumber, 1, 1);
+}
+
+// The merged block keeps this block's speaker and tags and the lower block's timestamp
+void Transcript::mergeBlocks(int blockNumber)
+{
+    auto upperId = blockId(blockNumber);
+    auto lowerId = blockId(blockNumber + 1);
+    auto upper = m_records[upperId];
+    auto lower = m_records[lowerId];
+
+    // Lines split earlier are still adjacent, otherwise the word entries are copied
+    // next to each other at the end of the arrays
+    if (upper.wordCount == 0)
+        upper.firstWord = lower.firstWord;
+    else if (upper.firstWord + upper.wordCount != lower.firstWord) {
+        if (upper.firstWord + upper.wordCount != m_wordTimes.size())
+            upper.firstWord = copyWords(upper);
+        copyWords(lower);
+    }
+
+    upper.wordCount += lower.wordCount;
+    upper.charCount += lower.charCount;
+    upper.timeStamp = lower.timeStamp;
+
+    removeIds(blockNumber + 1, 1);
+    releaseRecord(lowerId);
+    setRecord(upperId, upper);
+    markChanged(blockNumber, 1, 1);
+    maybeCompact();
+}
+
+void Transcript::setWordText(int blockNumber, int wordNumber, const QString& text)
+{
+    auto record = recordAt(blockNumber);
+    record.firstWord = copyWords(record);
+
+    auto index = record.firstWord + wordNumber;
+    record.charCount += text.size() - m_wordLengths[index];
+    m_wordOffsets[index] = m_arena.size();
+    m_wordLengths[index] = text.size();
+    m_wordKeys[index] = m_spellingKeys.insert(text);
+    m_arena.append(text);
+
+    setRecord(blockId(blockNumber), record);
+    markChanged(blockNumber, 1, 1);
+    maybeCompact();
+}
+
+int Transcript::createBlock(const block& b)
+{
+    BlockRecord record = {b.timeStamp, internSpeaker(b.speaker), internTags(b.tagList),
+                          m_wordTimes.size(), b.words.size(), 0};
+
+    growWords(b.words.size());
+    for (int i = 0; i < b.words.size(); i++) {
+        writeWord(record.firstWord + i, b.words[i]);
+        record.charCount += b.words[i].text.size();
+    }
+
+    return allocateRecord(record);
+}
+
+void Transcript::setBlockOrder(int first, int count, const QVector<int>& ids)
+{
+    // Lines edited in place keep their ids, the order doesn't change
+    if (m_order.ids(first, count) == ids) {
+        markChanged(first, count, count);
+        return;
+    }
+
+    QSet<int> kept;
+    for (auto id: ids)
+        kept.insert(id);
+
+    for (auto id: removeIds(first, count))
+        if (!kept.contains(id))
+            releaseRecord(id);
+    insertIds(first, ids);
+
+    maybeCompact();
+}
+
+void Transcript::beginCommand(const QString& text, bool mergeable)
+{
+    if (m_commandDepth++ > 0)
+        return;
+
+    m_command = Command();
+    m_command.text = text;
+    m_command.mergeable = mergeable;
+    m_touched.clear();
+    m_discardCommand = false;
+}
+
+void Transcript::endCommand()
+{
+    if (--m_commandDepth > 0)
+        return;
+
+    auto command = m_command;
+    m_command = Command();
+    m_touched.clear();
+
+    if (m_discardCommand || (command.ids.isEmpty() && command.orderEdits.isEmpty()))
+        return;
+
+    for (auto id: command.ids) {
+        command.after.append(m_records[id]);
+        command.usedAfter.append(m_inUse[id]);
+    }
+
+    // The ids created by the undone commands are free already, dropping them loses nothing
+    m_redoStack.clear();
+
+    if (!m_undoStack.isEmpty()) {
+        auto& last = m_undoStack.last();
+        const bool sameLine = command.ids.size() == 1 && last.ids == command.ids
+                && command.orderEdits.isEmpty() && last.orderEdits.isEmpty();
+
+        if (command.mergeable && last.mergeable && last.text == command.text && sameLine) {
+            last.after = command.after;
+            last.usedAfter = command.usedAfter;
+            return;
+        }
+    }
+
+    m_undoStack.append(command);
+    if (m_undoStack.size() > m_undoLimit)
+        m_undoStack.removeFirst();
+}
+
+void Transcript::undo()
+{
+    if (m_undoStack.isEmpty() || m_commandDepth > 0)
+        return;
+
+    auto command = m_undoStack.takeLast();
+    m_replaying = true;
+
+    for (int i = command.orderEdits.size() - 1; i >= 0; i--) {
+        const auto& edit = command.orderEdits[i];
+        removeIds(edit.position, edit.inserted.size());
+        insertIds(edit.position, edit.removed);
+    }
+    m_deferSpeakerBlocks = true;
+    for (int i = 0; i < command.ids.size(); i++) {
+        restoreRecord(command.ids[i], command.before[i]);
+        setInUse(command.ids[i], command.usedBefore[i]);
+    }
+    m_deferSpeakerBlocks = false;
+    rebuildSpeakerBlocks();
+
+    m_replaying = false;
+    m_redoStack.append(command);
+}
+
+void Transcript::redo()
+{
+    if (m_redoStack.isEmpty() || m_commandDepth > 0)
+        return;
+
+    auto command = m_redoStack.takeLast();
+    m_replaying = true;
+
+    for (const auto& edit: qAsConst(command.orderEdits)) {
+        removeIds(edit.position, edit.removed.size());
+        insertIds(edit.position, edit.inserted);
+    }
+    m_deferSpeakerBlocks = true;
+    for (int i = 0; i < command.ids.size(); i++) {
+        restoreRecord(command.ids[i], command.after[i]);
+        setInUse(command.ids[i], command.usedAfter[i]);
+    }
+    m_deferSpeakerBlocks = false;
+    rebuildSpeakerBlocks();
+
+    m_replaying = false;
+    m_undoStack.append(command);
+}
+
+void Transcript::clearHistory()
+{
+    m_undoStack.clear();
+    m_redoStack.clear();
+}
+
+Transcript::ChangeRange Transcript::changes() const
+{
+    ChangeRange range = {m_changeFirst, m_changeOldEnd - m_changeFirst, m_changeNewEnd - m_changeFirst};
+    return range;
+}
+
+void Transcript::markChanged(int first, int removed, int added)
+{
+    if (m_changeFirst == -1) {
+        m_changeFirst = first;
+        m_changeOldEnd = first + removed;
+        m_changeNewEnd = first + added;
+        return;
+    }
+
+    // Past the current window the new line numbers are shifted from the old ones by this much
+    auto shift = m_changeNewEnd - m_changeOldEnd;
+    auto changeEnd = qMax(m_changeNewEnd, first + removed);
+
+    m_changeFirst = qMin(m_changeFirst, first);
+    m_changeOldEnd = changeEnd - shift;
+    m_changeNewEnd = changeEnd + added - removed;
+}
+
+int Transcript::allocateRecord(const BlockRecord& record)
+{
+    int id = -1;
+    while (id == -1 && !m_freeIds.isEmpty()) {
+        auto candidate = m_freeIds.takeLast();
+        if (!m_inUse[candidate])
+            id = candidate;
+    }
+
+    if (id == -1) {
+        id = m_records.size();
+        m_records.append(record);
+        m_inUse.append(false);
+    }
+
+    // The slot's old content is what undoing the command restores
+    touch(id);
+    m_records[id] = record;
+    m_inUse[id] = true;
+    indexWords(id, record.firstWord, record.wordCount);
+    return id;
+}
+
+void Transcript::releaseRecord(int id)
+{
+    // Undoing the removal puts the record back as it was
+    touch(id);
+    setInUse(id, false);
+}
+
+void Transcript::setInUse(int id, bool inUse)
+{
+    if (!inUse && m_inUse[id])
+        m_freeIds.append(id);
+    m_inUse[id] = inUse;
+}
+
+// Every change to a record goes through here, so the totals and the history stay right
+void Transcript::setRecord(int id, const BlockRecord& record)
+{
+    touch(id);
+
+    if (m_order.contains(id)) {
+        m_liveWords += record.wordCount - m_records[id].wordCount;
+        m_liveChars += record.charCount - m_records[id].charCount;
+        if (record.timeStamp != m_records[id].timeStamp)
+            m_order.setTime(id, record.timeStamp);
+    }
+
+    auto speakerChanged = m_order.contains(id) && record.speaker != m_records[id].speaker;
+    if (speakerChanged && m_deferSpeakerBlocks) {
+        m_speakerBlocksStale = true;
+        speakerChanged = false;
+    }
+    if (speakerChanged)
+        removeSpeakerBlocks({id});
+
+    // Words appended in place are the only new ones in an unmoved range
+    const auto& old = m_records[id];
+    if (record.firstWord != old.firstWord)
+        indexWords(id, record.firstWord, record.wordCount);
+    else if (record.wordCount > old.wordCount)
+        indexWords(id, record.firstWord + old.wordCount, record.wordCount - old.wordCount);
+    m_records[id] = record;
+
+    if (speakerChanged)
+        addSpeakerBlocks({id});
+}
+
+void Transcript::restoreRecord(int id, const BlockRecord& record)
+{
+    setRecord(id, record);
+
+    auto blockNumber = m_order.positionOf(id);
+    if (blockNumber != -1)
+        markChanged(blockNumber, 1, 1);
+}
+
+void Transcript::insertIds(int position, const QVector<int>& ids)
+{
+    if (ids.isEmpty())
+        return;
+
+    m_order.insert(position, ids);
+    orderChanged();
+
+    for (auto id: ids) {
+        m_liveWords += m_records[id].wordCount;
+        m_liveChars += m_records[id].charCount;
+        m_order.setTime(id, m_records[id].timeStamp);
+    }
+    addSpeakerBlocks(ids);
+
+    recordOrderEdit(position, QVector<int>(), ids);
+    markChanged(position, 0, ids.size());
+}
+
+QVector<int> Transcript::removeIds(int position, int count)
+{
+    if (count <= 0)
+        return QVector<int>();
+
+    // Placed by their positions, which are gone once they are out of the order
+    removeSpeakerBlocks(m_order.ids(position, count));
+    auto removed = m_order.remove(position, count);
+    orderChanged();
+
+    for (auto id: removed) {
+        m_liveWords -= m_records[id].wordCount;
+        m_liveChars -= m_records[id].charCount;
+    }
+
+    recordOrderEdit(position, removed, QVector<int>());
+    markChanged(position, removed.size(), 0);
+    return removed;
+}
+
+// Saves the record's state before the open command first changes it
+void Transcript::touch(int id)
+{
+    if (m_replaying)
+        return;
+    if (m_commandDepth == 0) {
+        clearHistory();
+        return;
+    }
+    if (m_touched.contains(id))
+        return;
+
+    m_touched.insert(id);
+    m_command.ids.append(id);
+    m_command.before.append(m_records[id]);
+    m_command.usedBefore.append(m_inUse[id]);
+}
+
+void Transcript::recordOrderEdit(int position, const QVector<int>& removed, const QVector<int>& inserted)
+{
+    if (m_replaying)
+        return;
+    if (m_commandDepth == 0) {
+        clearHistory();
+        return;
+    }
+
+    OrderEdit edit = {position, removed, inserted};
+    m_command.orderEdits.append(edit);
+}
+
+int Transcript::internSpeaker(const QString& speaker)
+{
+    auto it = m_speakerIds.constFind(speaker);
+    if (it != m_speakerIds.constEnd())
+        return it.value();
+
+    m_speakers.append(speaker);
+    m_speakerIds.insert(speaker, m_speakers.size() - 1);
+    m_speakerBlocks.append(QVector<int>());
+    return m_speakers.size() - 1;
+}
+
+// Index of the first of the speaker's blocks at or after the position
+int Transcript::speakerBlockIndex(int speaker, int position) const
+{
+    const auto& ids = m_speakerBlocks[speaker];
+    auto found = std::lower_bound(ids.constBegin(), ids.constEnd(), position, [this](int id, int position) {
+        return m_order.positionOf(id) < position;
+    });
+    return int(found - ids.constBegin());
+}
+
+// The ids are consecutive blocks in the order, so each speaker's among them go in one run
+void Transcript::addSpeakerBlocks(const QVector<int>& ids)
+{
+    QHash<int, QVector<int>> runs;
+    for (auto id: ids)
+        runs[m_records[id].speaker].append(id);
+
+    for (auto it = runs.constBegin(); it != runs.constEnd(); ++it) {
+        auto& speakerIds = m_speakerBlocks[it.key()];
+        if (speakerIds.isEmpty())
+            m_speakersRevision++;
+
+        auto index = speakerBlockIndex(it.key(), m_order.positionOf(it.value().first()));
+        speakerIds.insert(index, it.value().size(), -1);
+        std::copy(it.value().constBegin(), it.value().constEnd(), speakerIds.begin() + index);
+    }
+}
+
+// Called while the ids, consecutive blocks, are still in the order
+void Transcript::removeSpeakerBlocks(const QVector<int>& ids)
+{
+    QHash<int, QVector<int>> runs;
+    for (auto id: ids)
+        runs[m_records[id].speaker].append(id);
+
+    for (auto it = runs.constBegin(); it != runs.constEnd(); ++it) {
+        auto& speakerIds = m_speakerBlocks[it.key()];
+        auto index = speakerBlockIndex(it.key(), m_order.positionOf(it.value().first()));
+        speakerIds.remove(index, it.value().size());
+        if (speakerIds.isEmpty())
+            m_speakersRevision++;
+    }
+}
+
+// Places every block again in one pass over the order, once records changed speaker while deferred
+void Transcript::rebuildSpeakerBlocks()
+{
+    if (!m_speakerBlocksStale)
+        return;
+    m_speakerBlocksStale = false;
+
+    QVector<bool> hadBlocks(m_speakerBlocks.size());
+    for (int i = 0; i < m_speakerBlocks.size(); i++) {
+        hadBlocks[i] = !m_speakerBlocks[i].isEmpty();
+        m_speakerBlocks[i].clear();
+    }
+    for (auto id: m_order.toVector())
+        m_speakerBlocks[m_records[id].speaker].append(id);
+
+    for (int i = 0; i < m_speakerBlocks.size(); i++) {
+        if (hadBlocks[i] == m_speakerBlocks[i].isEmpty()) {
+            m_speakersRevision++;
+            break;
+        }
+    }
+}
+
+int Transcript::internTags(const QStringList& tagList)
+{
+    auto key = tagList.join(",");
+    auto it = m_tagSetIds.constFind(key);
+    if (it != m_tagSetIds.constEnd())
+        return it.value();
+
+    m_tagSets.append(tagList);
+    m_tagSetIds.insert(key, m_tagSets.size() - 1);
+    return m_tagSets.size() - 1;
+}
+
+int Transcript::wordIndex(int blockNumber, int wordNumber) const
+{
+    return recordAt(blockNumber).firstWord + wordNumber;
+}
+
+void Transcript::growWords(int count)
+{
+    auto size = m_wordTimes.size() + count;
+    m_wordTimes.resize(size);
+    m_wordOffsets.resize(size);
+    m_wordLengths.resize(size);
+    m_wordTags.resize(size);
+    m_wordKeys.resize(size);
+}
+
+void Transcript::writeWord(int index, const word& w)
+{
+    writeWord(index, w.timeStamp, QStringView(w.text), w.tagList);
+}
+
+// text must not point into the arena, appending may reallocate it
+void Transcript::writeWord(int index, qint64 time, QStringView text, const QStringList& tagList)
+{
+    m_wordTimes[index] = time;
+    m_wordOffsets[index] = m_arena.size();
+    m_wordLengths[index] = text.size();
+    m_wordTags[index] = internTags(tagList);
+    m_wordKeys[index] = m_spellingKeys.insert(text);
+
+    m_arena.append(text.data(), text.size());
+}
+
+// Copies the record's word entries to the end of the arrays and returns where they start,
+// the text stays where it is
+int Transcript::copyWords(const BlockRecord& record)
+{
+    auto first = m_wordTimes.size();
+    growWords(record.wordCount);
+
+    for (int i = 0; i < record.wordCount; i++) {
+        m_wordTimes[first + i] = m_wordTimes[record.firstWord + i];
+        m_wordOffsets[first + i] = m_wordOffsets[record.firstWord + i];
+        m_wordLengths[first + i] = m_wordLengths[record.firstWord + i];
+        m_wordTags[first + i] = m_wordTags[record.firstWord + i];
+        m_wordKeys[first + i] = m_wordKeys[record.firstWord + i];
+    }
+    return first;
+}
+
+void Transcript::indexWords(int id, int firstWord, int wordCount)
+{
+    if (m_keyBlocks.size() < m_spellingKeys.size())
+        m_keyBlocks.resize(m_spellingKeys.size());
+
+    // A block rewritten over and over, as when typing, only adds itself once
+    for (int i = firstWord; i < firstWord + wordCount; i++) {
+        auto& ids = m_keyBlocks[m_wordKeys[i]];
+        if (ids.isEmpty() || ids.last() != id)
+            ids.append(id);
+    }
+}
+
+int Transcript::charCount(int firstWord, int wordCount) const
+{
+    int count = 0;
+    for (int i = firstWord; i < firstWord + wordCount; i++)
+        count += m_wordLengths[i];
+    return count;
+}
+
+void Transcript::maybeCompact()
+{
+    auto deadWords = m_wordTimes.size() - m_liveWords - m_retainedWords;
+    auto deadChars = m_arena.size() - m_liveChars - m_retainedChars;
+
+    const bool tooManyDeadWords = deadWords > 4096 && deadWords > m_wordTimes.size() / 2;
+    const bool tooManyDeadChars = deadChars > 65536 && deadChars > m_arena.size() / 2;
+
+    if (tooManyDeadWords || tooManyDeadChars)
+        compact();
+}
+
+// Drops the word entries and text no record refers to, the ones still used keep their
+// relative order so every range stays contiguous
+void Transcript::compact()
+{
+    QVector<BlockRecord*> records;
+    for (int id = 0; id < m_records.size(); id++)
+        records.append(&m_records[id]);
+    for (auto stack: {&m_undoStack, &m_redoStack})
+        for (auto& command: *stack) {
+            for (auto& record: command.before)
+                records.append(&record);
+            for (auto& record: command.after)
+                records.append(&record);
+        }
+    for (auto& record: m_command.before)
+        records.append(&record);
+
+    // Free slots may point at words nothing else uses, they are overwritten before being used
+    // again and the history keeps its own copy of any record it needs
+    QVector<bool> used(m_wordTimes.size(), false);
+    for (int i = 0; i < records.size(); i++) {
+        const auto& record = *records[i];
+        if (i < m_records.size() && !m_inUse[i])
+            continue;
+        for (int j = record.firstWord; j < record.firstWord + record.wordCount; j++)
+            used[j] = true;
+    }
+
+    QVector<int> newIndex(m_wordTimes.size() + 1, 0);
+    for (int i = 0; i < m_wordTimes.size(); i++)
+        newIndex[i + 1] = newIndex[i] + (used[i] ? 1 : 0);
+
+    auto keptWords = newIndex[m_wordTimes.size()];
+    QVector<qint64> wordTimes;
+    QVector<int> wordOffsets, wordLengths;
+    QVector<int> wordTags;
+    QVector<int> wordKeys;
+    QString arena;
+    QHash<int, int> textOffsets;
+
+    wordTimes.reserve(keptWords);
+    wordOffsets.reserve(keptWords);
+    wordLengths.reserve(keptWords);
+    wordTags.reserve(keptWords);
+    wordKeys.reserve(keptWords);
+    arena.reserve(m_liveChars + m_retainedChars);
+
+    for (int i = 0; i < m_wordTimes.size(); i++) {
+        if (!used[i])
+            continue;
+
+        // Copied entries share their text, keep sharing it
+        auto it = textOffsets.constFind(m_wordOffsets[i]);
+        if (it == textOffsets.constEnd()) {
+            it = textOffsets.insert(m_wordOffsets[i], arena.size());
+            arena.append(m_arena.constData() + m_wordOffsets[i], m_wordLengths[i]);
+        }
+
+        wordTimes.append(m_wordTimes[i]);
+        wordOffsets.append(it.value());
+        wordLengths.append(m_wordLengths[i]);
+        wordTags.append(m_wordTags[i]);
+        wordKeys.append(m_wordKeys[i]);
+    }
+
+    for (int i = 0; i < records.size(); i++) {
+        auto& record = *records[i];
+        if (record.wordCount > 0 && used[record.firstWord])
+            record.firstWord = newIndex[record.firstWord];
+        else if (i < m_records.size() && !m_inUse[i]) {
+            record.firstWord = 0;
+            record.wordCount = record.charCount = 0;
+        }
+        else
+            record.firstWord = newIndex[qMin(record.firstWord, m_wordTimes.size())];
+    }
+
+    m_wordTimes.swap(wordTimes);
+    m_wordOffsets.swap(wordOffsets);
+    m_wordLengths.swap(wordLengths);
+    m_wordTags.swap(wordTags);
+    m_wordKeys.swap(wordKeys);
+    m_arena.swap(arena);
+
+    m_retainedWords = m_wordTimes.size() - m_liveWords;
+    m_retainedChars = m_arena.size() - m_liveChars;
+
+    // Only records in use are indexed again, the history indexes its own when it restores them
+    for (auto& ids: m_keyBlocks)
+        ids.clear();
+    for (int id = 0; id < m_records.size(); id++)
+        if (m_inUse[id])
+            indexWords(id, m_records[id].firstWord, m_records[id].wordCount);
+}
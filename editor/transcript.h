@@ -0,0 +1,257 @@
+#pragma once
+
+#include "blockandword.h"
+#include "blocksequence.h"
+#include "dictionary.h"
+
+#include <QHash>
+#include <QSet>
+#include <QString>
+#include <QStringList>
+#include <QStringView>
+#include <QVector>
+
+// Compact storage for a transcript. Word text lives in one shared arena,
+// timestamps are kept as milliseconds (-1 when absent) and speakers / tag
+// lists are interned, so a word costs a few bytes plus its characters.
+//
+// Every block has a stable id that survives lines being inserted or removed
+// around it, the editor keeps the id on the matching document block so an
+// edit can be resolved to its record without realigning by position.
+//
+// Word entries are never changed once written, an edit writes a new range and
+// points the record at it. The undo history therefore only keeps the records
+// an edit replaced and the ids it moved, the words stay shared with the
+// current state until a compaction drops the ones nothing refers to anymore.
+class Transcript
+{
+public:
+    // Lines changed since the last clearChanges(), merged into one window:
+    // the old lines [first, first + removed) are now [first, first + added)
+    struct ChangeRange
+    {
+        int first;
+        int removed;
+        int added;
+    };
+
+    // The spelling keys of every block's words as they are now. The containers are shared
+    // with the transcript until it next changes, so taking one is cheap and it can be read
+    // from another thread while the transcript is edited.
+    struct KeySnapshot
+    {
+        Dictionary keys;
+        QVector<int> wordKeys;
+        QVector<int> blockIds;      // in block order, like the two below
+        QVector<int> firstWords;
+        QVector<int> wordCounts;
+    };
+
+    Transcript();
+
+    void clear();
+    bool isEmpty() const { return m_order.isEmpty(); }
+    int blockCount() const { return m_order.size(); }
+    int blockId(int blockNumber) const;
+    int blockNumber(int id) const { return m_order.positionOf(id); }
+
+    qint64 blockTime(int blockNumber) const;
+    QString speaker(int blockNumber) const;
+    QStringList blockTags(int blockNumber) const;
+    QString blockText(int blockNumber) const;
+    int wordCount(int blockNumber) const;
+
+    // The block and word playing at a position are the first ones whose time stamp is past it
+    int blockAfter(qint64 time) const { return m_order.firstAfter(time); }
+    int wordAfter(int blockNumber, qint64 time) const;
+
+    QStringView wordText(int blockNumber, int wordNumber) const;
+    // Spelling key of the word, computed once when the word is written
+    int wordKey(int blockNumber, int wordNumber) const;
+    QStringView keyText(int key) const { return m_spellingKeys.key(key); }
+    uint keyHash(int key) const { return m_spellingKeys.hash(key); }
+    // Numbers of the blocks with a word of that key, in order
+    QVector<int> blocksWithKey(int key) const;
+    KeySnapshot keySnapshot() const;
+
+    // Misspelt words of each block as the editor last found them, kept along the block order
+    void setInvalidWordCount(int id, int count) { m_order.setMarks(id, count); }
+    int invalidWordCount() const { return m_order.markCount(); }
+    // The first block with misspelt words at or after the block, the last one at or before it
+    int nextInvalidBlock(int blockNumber) const { return m_order.firstMarked(blockNumber); }
+    int previousInvalidBlock(int blockNumber) const { return m_order.lastMarked(blockNumber); }
+    qint64 wordTime(int blockNumber, int wordNumber) const;
+    QStringList wordTags(int blockNumber, int wordNumber) const;
+
+    block blockAt(int blockNumber) const;
+    QVector<word> words(int blockNumber) const;
+    // Speakers with at least one block, in the order they were first used
+    QStringList speakers() const;
+    // Changes whenever a speaker gets its first block or loses its last one
+    int speakersRevision() const { return m_speakersRevision; }
+    // Numbers of the speaker's blocks, in order
+    QVector<int> speakerBlocks(const QString& speaker) const;
+    // The nearest block after or before the block with its speaker, -1 if there is none
+    int nextSpeakerTurn(int blockNumber) const { return speakerTurn(blockNumber, 1); }
+    int previousSpeakerTurn(int blockNumber) const { return speakerTurn(blockNumber, -1); }
+
+    void setBlockTime(int blockNumber, qint64 time);
+    void setSpeaker(int blockNumber, const QString& speaker);
+    // Gives every block of the speaker to the new one, the speakers' blocks are placed once for all
+    void renameSpeaker(const QString& speaker, const QString& newSpeaker);
+    void setBlockTags(int blockNumber, const QStringList& tagList);
+    void setWordTime(int blockNumber, int wordNumber, qint64 time);
+    void setWords(int blockNumber, const QVector<word>& words);
+
+    int appendBlock(qint64 time, const QString& speaker, const QStringList& tagList);
+    void appendWord(int blockNumber, qint64 time, QStringView text, const QStringList& tagList);
+    void appendBlock(const block& b) { insertBlock(blockCount(), b); }
+    void insertBlock(int blockNumber, const block& b);
+    void replaceBlock(int blockNumber, const block& b);
+    void removeBlock(int blockNumber);
+
+    // Moves the words from wordNumber on into a new block after this one, and merges the block
+    // below into this one. Only the word ranges are adjusted, no text is copied.
+    void splitBlock(int blockNumber, int wordNumber);
+    void mergeBlocks(int blockNumber);
+    void setWordText(int blockNumber, int wordNumber, const QString& text);
+
+    // Creates a record that is not part of the transcript until it is placed with setBlockOrder()
+    int createBlock(const block& b);
+    // Replaces the blocks [first, first + count) with the given ids, records left out are released
+    void setBlockOrder(int first, int count, const QVector<int>& ids);
+
+    // Changes made between beginCommand() and endCommand() are undone as one step, changes made
+    // outside of a command clear the history. Consecutive mergeable commands on the same line are
+    // joined, like typing in a text editor.
+    void beginCommand(const QString& text, bool mergeable = false);
+    void endCommand();
+    bool canUndo() const { return !m_undoStack.isEmpty(); }
+    bool canRedo() const { return !m_redoStack.isEmpty(); }
+    QString undoText() const { return canUndo() ? m_undoStack.last().text : QString(); }
+    QString redoText() const { return canRedo() ? m_redoStack.last().text : QString(); }
+    void undo();
+    void redo();
+    void clearHistory();
+
+    bool hasChanges() const { return m_changeFirst != -1; }
+    ChangeRange changes() const;
+    void clearChanges() { m_changeFirst = m_changeOldEnd = m_changeNewEnd = -1; }
+
+private:
+    struct BlockRecord
+    {
+        qint64 timeStamp;
+        int speaker;
+        int tags;
+        int firstWord;
+        int wordCount;
+        int charCount;
+    };
+
+    // The ids removed from and inserted into the block order at a position
+    struct OrderEdit
+    {
+        int position;
+        QVector<int> removed;
+        QVector<int> inserted;
+    };
+
+    struct Command
+    {
+        QString text;
+        bool mergeable{false};
+        QVector<int> ids;                   // records changed, with their state before and after
+        QVector<BlockRecord> before;
+        QVector<BlockRecord> after;
+        QVector<bool> usedBefore;
+        QVector<bool> usedAfter;
+        QVector<OrderEdit> orderEdits;
+    };
+
+    const BlockRecord& recordAt(int blockNumber) const { return m_records[blockId(blockNumber)]; }
+    void orderChanged() { m_lastBlockNumber = -1; }
+    int allocateRecord(const BlockRecord& record);
+    void releaseRecord(int id);
+    void setInUse(int id, bool inUse);
+    void setRecord(int id, const BlockRecord& record);
+    void restoreRecord(int id, const BlockRecord& record);
+    void insertIds(int position, const QVector<int>& ids);
+    QVector<int> removeIds(int position, int count);
+
+    bool recording() const { return m_commandDepth > 0 && !m_replaying; }
+    void touch(int id);
+    void recordOrderEdit(int position, const QVector<int>& removed, const QVector<int>& inserted);
+
+    int internSpeaker(const QString& speaker);
+    int speakerBlockIndex(int speaker, int position) const;
+    void addSpeakerBlocks(const QVector<int>& ids);
+    void removeSpeakerBlocks(const QVector<int>& ids);
+    void rebuildSpeakerBlocks();
+    int speakerTurn(int blockNumber, int step) const;
+    int internTags(const QStringList& tagList);
+    int wordIndex(int blockNumber, int wordNumber) const;
+    void growWords(int count);
+    void writeWord(int index, const word& w);
+    void writeWord(int index, qint64 time, QStringView text, const QStringList& tagList);
+    int copyWords(const BlockRecord& record);
+    int charCount(int firstWord, int wordCount) const;
+    void indexWords(int id, int firstWord, int wordCount);
+    void markChanged(int first, int removed, int added);
+    void maybeCompact();
+    void compact();
+
+    // Records are indexed by block id, m_order holds the ids in document order
+    QVector<BlockRecord> m_records;
+    QVector<bool> m_inUse;
+    QVector<int> m_freeIds;             // may hold ids that are in use again, those are skipped
+    BlockSequence m_order;
+
+    // Accessors are called many times in a row for the same block, skip the tree walk for those
+    mutable int m_lastBlockNumber{-1};
+    mutable int m_lastBlockId{-1};
+
+    // Words of every block, stored as parallel arrays
+    QVector<qint64> m_wordTimes;
+    QVector<int> m_wordOffsets;
+    QVector<int> m_wordLengths;
+    QVector<int> m_wordTags;            // indexes into m_tagSets, which can pass 65535
+    QVector<int> m_wordKeys;
+    QString m_arena;
+
+    // Every spelling key seen, words refer to theirs by index
+    Dictionary m_spellingKeys;
+
+    // Ids of the records that had a word of each key when they were written. Records
+    // change, so an id is only a candidate, entries are dropped at compaction.
+    QVector<QVector<int>> m_keyBlocks;
+
+    QStringList m_speakers;
+    QHash<QString, int> m_speakerIds;
+    // Ids of each speaker's blocks in the order, sorted by position. Lines moving elsewhere don't
+    // change how they sort, so only the ids of the blocks inserted or removed are placed.
+    QVector<QVector<int>> m_speakerBlocks;
+    int m_speakersRevision{0};
+    // While records of many blocks change speaker the lists are rebuilt after them, not per block
+    bool m_deferSpeakerBlocks{false};
+    bool m_speakerBlocksStale{false};
+    QVector<QStringList> m_tagSets;
+    QHash<QString, int> m_tagSetIds;
+
+    // Totals over the blocks in the order, and what the last compaction kept for the history
+    int m_liveWords{0};
+    int m_liveChars{0};
+    int m_retainedWords{0};
+    int m_retainedChars{0};
+
+    Command m_command;
+    QSet<int> m_touched;
+    int m_commandDepth{0};
+    bool m_discardCommand{false};
+    bool m_replaying{false};
+    QVector<Command> m_undoStack;
+    QVector<Command> m_redoStack;
+    int m_undoLimit{100};
+
+    int m_changeFirst{-1}, m_changeOldEnd{-1}, m_changeNewEnd{-1};
+};
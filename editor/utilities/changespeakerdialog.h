@@ -29,9 +29,11 @@ public:
         return ui->checkBox_changeAllOccurences->isChecked();
     }
     
-    void addItems(const QStringList& speakers) const
+    // The model is the editor's, a name typed in isn't added to it
+    void setSpeakerModel(QAbstractItemModel* speakers) const
     {
-        ui->comboBox_speaker->addItems(speakers);
+        ui->comboBox_speaker->setInsertPolicy(QComboBox::NoInsert);
+        ui->comboBox_speaker->setModel(speakers);
     }
 
     void setCurrentSpeaker(const QString& speakerName) const
@@ -83,18 +83,22 @@ void FindReplaceDialog::replace()
 
 void FindReplaceDialog::replaceAll()
 {
-    QTextCursor textCursor = m_Editor->textCursor();
-    textCursor.movePosition(QTextCursor::Start, QTextCursor::MoveAnchor,1);
-    m_Editor->setTextCursor(textCursor);
-
     QString query = ui->text_find->text();
     QString replacementString = ui->text_replace->text();
-    short replacementCount{0};
+    int replacementCount{0};
 
-    while (m_Editor->find(query, flags)) {
-        m_Editor->textCursor().insertText(replacementString);
+    // Replacing inside one edit block makes the document report a single change, so the lines
+    // are synced to the transcript and highlighted once instead of after every replacement
+    auto document = m_Editor->document();
+    QTextCursor editBlock(document);
+    editBlock.beginEditBlock();
+
+    for (auto found = document->find(query, 0, flags); !found.isNull(); found = document->find(query, found, flags)) {
+        found.insertText(replacementString);
         ++replacementCount;
     }
 
+    editBlock.endEditBlock();
+
     emit message("Replaced " + QString::number(replacementCount) + " occurences.");
 }
@@ -50,6 +50,8 @@ void KeyboardShortcutGuide::fillDialog() {
     QStringList saveTranscript({"Save Transcript", QKeySequence(Qt::CTRL+Qt::Key_S).toString()});
     QStringList splitLine({"Split Line", QKeySequence(Qt::CTRL+Qt::Key_Semicolon).toString()});
     QStringList jumpToHighlightedLine({"Jump to Highlighted Line", QKeySequence(Qt::CTRL+Qt::Key_J).toString()});
+    QStringList nextInvalidWord({"Next Misspelt Word", QKeySequence(Qt::Key_F7).toString()});
+    QStringList previousInvalidWord({"Previous Misspelt Word", QKeySequence(Qt::SHIFT+Qt::Key_F7).toString()});
     QStringList mergeUp({"Merge Up", QKeySequence(Qt::CTRL+Qt::Key_Up).toString()});
     QStringList mergeDown({"Merge Down", QKeySequence(Qt::CTRL+Qt::Key_Down).toString()});
     QStringList toggleWordEditor({"Toggle Word Editor", QKeySequence(Qt::CTRL+Qt::Key_W).toString()});
@@ -68,6 +70,8 @@ void KeyboardShortcutGuide::fillDialog() {
     editing->addChild(new QTreeWidgetItem(saveTranscript));
     editing->addChild(new QTreeWidgetItem(splitLine));
     editing->addChild(new QTreeWidgetItem(jumpToHighlightedLine));
+    editing->addChild(new QTreeWidgetItem(nextInvalidWord));
+    editing->addChild(new QTreeWidgetItem(previousInvalidWord));
     editing->addChild(new QTreeWidgetItem(mergeUp));
     editing->addChild(new QTreeWidgetItem(mergeDown));
     editing->addChild(new QTreeWidgetItem(toggleWordEditor));
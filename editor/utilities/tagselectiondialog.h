@@ -15,6 +15,11 @@ public:
     ~TagSelectionDialog();
     QStringList tagList() const;
 
+    static const QStringList& languages();
+    static const QStringList& languageCodes();
+    // The lower case name of the language a Lang_ tag's code stands for, empty for an unknown code
+    static QString languageName(const QString& languageCode);
+
 public slots:
     void markExistingTags(const QStringList& existingTagsList);
 
@@ -1,7 +1,6 @@
 #pragma once
 
 #include <QDialog>
-#include <QTime>
 #include "ui_timepropagationdialog.h"
 
 namespace Ui {
@@ -23,13 +22,11 @@ public:
 
     ~TimePropagationDialog() {delete ui;}
 
-    QTime time() const
+    // Milliseconds to shift the time stamps by
+    qint64 time() const
     {
-        int ms = (ui->spinBox_s->value() - (long)ui->spinBox_s->value()) * 1000;
-        return QTime(ui->spinBox_h->value(),
-                     ui->spinBox_m->value(),
-                     ui->spinBox_s->value(),
-                     ms);
+        return ((ui->spinBox_h->value() * 60LL + ui->spinBox_m->value()) * 60 * 1000)
+                + qRound64(ui->spinBox_s->value() * 1000);
     }
 
     void setBlockRange(int currentBlockNumber, int end)
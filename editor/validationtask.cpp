@@ -0,0 +1,71 @@
+#include "validationtask.h"
+
+ValidationTask::ValidationTask(const QSharedPointer<const ValidationSnapshot>& snapshot, int first, int count,
+                               const Callback& done)
+    : m_snapshot(snapshot), m_first(first), m_count(count), m_done(done)
+{
+}
+
+void ValidationTask::run()
+{
+    const auto& snapshot = *m_snapshot;
+    const auto& transcript = snapshot.transcript;
+
+    QVector<QBitArray> invalidWords(m_count), unlikelyWords(m_count);
+    QVector<QStringView> keys;
+    for (int i = 0; i < m_count; i++) {
+        auto block = m_first + i;
+        auto& bits = invalidWords[i];
+        bits.resize(transcript.wordCounts[block]);
+
+        auto dictionaryIndex = snapshot.blockDictionaries[block];
+        auto dictionary = dictionaryIndex == -1 ? nullptr : snapshot.dictionaries[dictionaryIndex].data();
+        if (!dictionary)
+            continue;
+
+        keys.resize(bits.size());
+        for (int j = 0; j < bits.size(); j++) {
+            auto key = transcript.wordKeys[transcript.firstWords[block] + j];
+            auto keyText = transcript.keys.key(key);
+            auto keyHash = transcript.keys.hash(key);
+            keys[j] = keyText;
+            if (!dictionary->words.contains(keyText, keyHash)
+                && !snapshot.correctedKeys.contains(keyText, keyHash))
+                bits.setBit(j);
+        }
+
+        unlikelyWords[i] = findUnlikelyWords(dictionary->phrases, keys, bits);
+    }
+
+    m_done(m_first, invalidWords, unlikelyWords);
+}
+
+QBitArray ValidationTask::findUnlikelyWords(const NGramModel& model, const QVector<QStringView>& keys,
+                                            const QBitArray& invalidWords)
+{
+    QBitArray bits(keys.size());
+    if (model.isEmpty())
+        return bits;
+
+    // Whether each word is unlikely after the one before it, -1 when either is misspelt
+    QVector<int> unlikelyAfter(keys.size(), -1);
+    for (int j = 1; j < keys.size(); j++)
+        if (!invalidWords.testBit(j - 1) && !invalidWords.testBit(j))
+            unlikelyAfter[j] = model.isUnlikelyPair(keys[j - 1], keys[j]) ? 1 : 0;
+
+    // A word between two unlikely pairs is the one out of place. A word in only one pair, at the end
+    // of the line or next to a misspelt word, is marked when its partner isn't already.
+    auto before = [&unlikelyAfter](int j) { return unlikelyAfter[j]; };
+    auto after = [&unlikelyAfter](int j) { return j + 1 < unlikelyAfter.size() ? unlikelyAfter[j + 1] : -1; };
+    for (int j = 0; j < keys.size(); j++)
+        if (before(j) == 1 && after(j) == 1)
+            bits.setBit(j);
+
+    for (int j = 0; j < keys.size(); j++) {
+        if (before(j) == 1 && after(j) == -1 && !bits.testBit(j - 1))
+            bits.setBit(j);
+        else if (after(j) == 1 && before(j) == -1 && !bits.testBit(j + 1))
+            bits.setBit(j);
+    }
+    return bits;
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include "transcript.h"
+#include "dictionarymanager.h"
+
+#include <QBitArray>
+#include <QRunnable>
+#include <QSharedPointer>
+#include <QVector>
+
+#include <functional>
+
+// What a validation pass checks the words against, shared by its tasks. None of
+// it changes once taken, so the tasks read it without locking.
+struct ValidationSnapshot
+{
+    Transcript::KeySnapshot transcript;
+    // Dictionaries in use and the one of each block, -1 or a null one while loading lets the words pass
+    QVector<QSharedPointer<const LanguageDictionary>> dictionaries;
+    QVector<int> blockDictionaries;
+    Dictionary correctedKeys;
+    QVector<int> revisions;         // BlockData revisions of the lines when the snapshot was taken
+    int generation{0};
+};
+
+// Checks the words of a range of blocks on a pool thread and hands two bit arrays
+// per block to the callback, the misspelt words and the correctly spelt ones
+// unlikely where they are. The callback is also called on the pool thread.
+class ValidationTask : public QRunnable
+{
+public:
+    using Callback = std::function<void(int first, const QVector<QBitArray>& invalidWords,
+                                        const QVector<QBitArray>& unlikelyWords)>;
+
+    ValidationTask(const QSharedPointer<const ValidationSnapshot>& snapshot, int first, int count,
+                   const Callback& done);
+    void run() override;
+
+    // The words of a line the model has never seen next to their neighbours, though they are common
+    // enough that it should have. A misspelt word isn't marked and is no evidence for its neighbours.
+    static QBitArray findUnlikelyWords(const NGramModel& model, const QVector<QStringView>& keys,
+                                       const QBitArray& invalidWords);
+
+private:
+    QSharedPointer<const ValidationSnapshot> m_snapshot;
+    int m_first;
+    int m_count;
+    Callback m_done;
+};
@@ -21,7 +21,7 @@ QVector<word> WordEditor::currentWords() const
 
     for (int i = 0; i < rowCount(); i++) {
         auto text = item(i, 0)->text();
-        auto timeStamp = getTime(item(i, 1)->text());
+        auto timeStamp = TimeStamp::parse(item(i, 1)->text());
         QStringList tagList;
 
         if (item(i, 2)->checkState() == Qt::Checked)
@@ -35,7 +35,7 @@ QVector<word> WordEditor::currentWords() const
     return wordsToReturn;
 }
 
-void WordEditor::refreshWords(const QVector<word>& words)
+void WordEditor::refreshWords(const Transcript& transcript, int blockNumber)
 {
     clear();
 
@@ -44,41 +44,39 @@ void WordEditor::refreshWords(const QVector<word>& words)
     setHorizontalHeaderItem(2, new QTableWidgetItem("InvW"));
     setHorizontalHeaderItem(3, new QTableWidgetItem("Slacked"));
 
-    if (words.isEmpty())
+    auto wordCount = transcript.wordCount(blockNumber);
+    if (!wordCount)
         return;
 
-    setRowCount(words.size());
+    setRowCount(wordCount);
 
-    int counter = 0;
-    for (auto& a_word: words) {
-        auto text = a_word.text;
-        auto timeStamp = a_word.timeStamp;
-        auto tagList = a_word.tagList;
+    for (int i = 0; i < wordCount; i++) {
+        auto text = transcript.wordText(blockNumber, i).toString();
+        auto timeStamp = transcript.wordTime(blockNumber, i);
+        auto tagList = transcript.wordTags(blockNumber, i);
 
-        setItem(counter, 0, new QTableWidgetItem(text));
-        setItem(counter, 1, new QTableWidgetItem(timeStamp.toString("hh:mm:ss.zzz")));
-        setItem(counter, 2, new QTableWidgetItem);
-        setItem(counter, 3, new QTableWidgetItem);
+        setItem(i, 0, new QTableWidgetItem(text));
+        setItem(i, 1, new QTableWidgetItem(TimeStamp::format(timeStamp)));
+        setItem(i, 2, new QTableWidgetItem);
+        setItem(i, 3, new QTableWidgetItem);
 
         if (tagList.contains("InvW"))
-            item(counter, 2)->setCheckState(Qt::Checked);
+            item(i, 2)->setCheckState(Qt::Checked);
         else
-            item(counter, 2)->setCheckState(Qt::Unchecked);
+            item(i, 2)->setCheckState(Qt::Unchecked);
 
         if (tagList.contains("Slacked"))
-            item(counter, 3)->setCheckState(Qt::Checked);
+            item(i, 3)->setCheckState(Qt::Checked);
         else
-            item(counter, 3)->setCheckState(Qt::Unchecked);
-
-        counter++;
+            item(i, 3)->setCheckState(Qt::Unchecked);
     }
 
     fitTableContents();
 }
 
-void WordEditor::insertTimeStamp(const QTime& timeToInsert)
+void WordEditor::insertTimeStamp(qint64 timeToInsert)
 {
-    item(currentRow(), 1)->setText(timeToInsert.toString("hh:mm:ss.zzz"));
+    item(currentRow(), 1)->setText(TimeStamp::format(timeToInsert));
 }
 
 void WordEditor::fitTableContents()
@@ -89,16 +87,4 @@ void WordEditor::fitTableContents()
     horizontalHeader()->setSectionResizeMode(1, QHeaderView::Stretch);
 }
 
-QTime WordEditor::getTime(const QString& text)
-{
-    if (text.contains(".")) {
-        if (text.count(":") == 2) return QTime::fromString(text, "h:m:s.z");
-        return QTime::fromString(text, "m:s.z");
-    }
-    else {
-        if (text.count(":") == 2) return QTime::fromString(text, "h:m:s");
-        return QTime::fromString(text, "m:s");
-    }
-}
-
 
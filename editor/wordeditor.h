@@ -1,7 +1,8 @@
 #pragma once
 
 #include <QTableWidget>
-#include "blockandword.h"
+#include "transcript.h"
+#include "timestamp.h"
 
 class WordEditor: public QTableWidget
 {
@@ -13,9 +14,6 @@ public:
     void fitTableContents();
 
 public slots:
-    void refreshWords(const QVector<word>& words);
-    void insertTimeStamp(const QTime& timeToInsert);
-
-private:
-    static QTime getTime(const QString& text);
+    void refreshWords(const Transcript& transcript, int blockNumber);
+    void insertTimeStamp(qint64 timeToInsert);
 };
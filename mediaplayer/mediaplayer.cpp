@@ -1,26 +1,62 @@
 #include "mediaplayer.h"
+#include "editor/timestamp.h"
 
 MediaPlayer::MediaPlayer(QWidget *parent)
     : QMediaPlayer(parent)
 {
+    // The player only reports its position every so often, the playhead fills in between
+    m_playheadTimer.setTimerType(Qt::PreciseTimer);
+    m_playheadTimer.setInterval(16);
+
+    connect(this, &QMediaPlayer::positionChanged, this, &MediaPlayer::syncPlayhead);
+    connect(&m_playheadTimer, &QTimer::timeout, this, [this]() {
+        // A notification slightly behind the extrapolated position shouldn't pull the playhead back
+        auto position = playheadPosition();
+        if (position > m_lastPlayhead || m_lastPlayhead - position > 250) {
+            m_lastPlayhead = position;
+            emit playheadMoved(position);
+        }
+    });
+    connect(this, &QMediaPlayer::stateChanged, this, [this](QMediaPlayer::State state) {
+        syncPlayhead(position());
+        if (state == QMediaPlayer::PlayingState)
+            m_playheadTimer.start();
+        else
+            m_playheadTimer.stop();
+    });
 }
 
-QTime MediaPlayer::elapsedTime()
+qint64 MediaPlayer::playheadPosition() const
 {
-    return getTimeFromPosition(position());
+    if (state() != QMediaPlayer::PlayingState || !m_sinceNotification.isValid())
+        return m_notifiedPosition;
+
+    auto position = m_notifiedPosition + qint64(m_sinceNotification.elapsed() * playbackRate());
+    return duration() > 0 ? qMin(position, duration()) : position;
 }
 
-QTime MediaPlayer::durationTime()
+void MediaPlayer::syncPlayhead(qint64 position)
 {
-    return getTimeFromPosition(duration());
+    // While playing a notification within this of the extrapolated position is drift, further off
+    // it is a seek, however short
+    static constexpr qint64 maxDrift = 100;
+    auto seeked = qAbs(position - playheadPosition()) > maxDrift;
+
+    m_notifiedPosition = position;
+    m_sinceNotification.start();
+
+    // Seeks and paused updates are passed on right away, while playing the timer follows up
+    if ((!m_playheadTimer.isActive() || seeked) && position != m_lastPlayhead) {
+        m_lastPlayhead = position;
+        emit playheadMoved(position);
+    }
 }
 
-void MediaPlayer::setPositionToTime(const QTime& time)
+void MediaPlayer::setPositionToTime(qint64 time)
 {
-    if (time.isNull())
+    if (time < 0)
         return;
-    qint64 position = 3600000*time.hour() + 60000*time.minute() + 1000*time.second() + time.msec();
-    setPosition(position);
+    setPosition(time);
 }
 
 QString MediaPlayer::getMediaFileName()
@@ -30,10 +66,10 @@ QString MediaPlayer::getMediaFileName()
 
 QString MediaPlayer::getPositionInfo()
 {
-    QString format = "mm:ss";
-    if (durationTime().hour() != 0)
-        format = "hh:mm:ss";
-    return elapsedTime().toString(format) + " / " + durationTime().toString(format);
+    // Hours are only shown for media of an hour or more
+    auto skipHours = durationTime() < TimeStamp::fromParts(1, 0, 0) ? 3 : 0;
+    return TimeStamp::format(elapsedTime(), false).mid(skipHours) + " / "
+            + TimeStamp::format(durationTime(), false).mid(skipHours);
 }
 
 void MediaPlayer::open()
@@ -56,22 +92,7 @@ void MediaPlayer::open()
 
 void MediaPlayer::seek(int seconds)
 {
-    if (elapsedTime().addSecs(seconds) > durationTime())
-        setPosition(duration());
-    else if (elapsedTime().addSecs(seconds).isNull())
-        setPosition(0);
-    else
-        setPositionToTime(elapsedTime().addSecs(seconds));
-}
-
-QTime MediaPlayer::getTimeFromPosition(const qint64& position)
-{
-    auto milliseconds = position % 1000;
-    auto seconds = (position/1000) % 60;
-    auto minutes = (position/60000) % 60;
-    auto hours = (position/3600000) % 24;
-
-    return QTime(hours, minutes, seconds, milliseconds);
+    setPosition(qBound(qint64(0), position() + seconds * 1000LL, duration()));
 }
 
 void MediaPlayer::togglePlayback()
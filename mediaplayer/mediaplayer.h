@@ -4,16 +4,19 @@
 #include <QMediaPlayer>
 #include <QFileDialog>
 #include <QStandardPaths>
-#include <QTime>
+#include <QElapsedTimer>
+#include <QTimer>
 
 class MediaPlayer : public QMediaPlayer
 {
     Q_OBJECT
 public:
     explicit MediaPlayer(QWidget *parent = nullptr);
-    QTime elapsedTime();
-    QTime durationTime();
-    void setPositionToTime(const QTime& time);
+    qint64 elapsedTime() { return position(); }
+    qint64 durationTime() { return duration(); }
+    // Position between the player's own notifications, extrapolated from the last one
+    qint64 playheadPosition() const;
+    void setPositionToTime(qint64 time);
     QString getMediaFileName();
     QString getPositionInfo();
 
@@ -24,8 +27,15 @@ public slots:
 
 signals:
     void message(QString text, int timeout = 5000);
+    // Emitted at display rate while playing and on every seek, for following the media closely
+    void playheadMoved(qint64 position);
 
 private:
-    static QTime getTimeFromPosition(const qint64& position);
+    void syncPlayhead(qint64 position);
+
     QString m_mediaFileName;
+    QTimer m_playheadTimer;
+    QElapsedTimer m_sinceNotification;
+    qint64 m_notifiedPosition{0};
+    qint64 m_lastPlayhead{-1};
 };
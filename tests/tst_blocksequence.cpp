@@ -0,0 +1,110 @@
+#include "editor/blocksequence.h"
+
+#include <QRandomGenerator>
+#include <QtTest>
+
+class TestBlockSequence : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void insertAndRemove();
+    void randomEdits();
+    void firstAfter();
+
+private:
+    static void compare(const BlockSequence& sequence, const QVector<int>& expected);
+};
+
+// Every lookup must agree with a plain vector of the same ids
+void TestBlockSequence::compare(const BlockSequence& sequence, const QVector<int>& expected)
+{
+    QCOMPARE(sequence.size(), expected.size());
+    QCOMPARE(sequence.isEmpty(), expected.isEmpty());
+    QCOMPARE(sequence.toVector(), expected);
+    for (int position = 0; position < expected.size(); position++) {
+        QCOMPARE(sequence.at(position), expected[position]);
+        QCOMPARE(sequence.positionOf(expected[position]), position);
+    }
+    QCOMPARE(sequence.at(expected.size()), -1);
+}
+
+void TestBlockSequence::insertAndRemove()
+{
+    BlockSequence sequence;
+    compare(sequence, {});
+
+    sequence.insert(0, {0, 1, 2});
+    sequence.insert(1, 3);
+    sequence.insert(4, {4, 5});
+    compare(sequence, {0, 3, 1, 2, 4, 5});
+
+    QCOMPARE(sequence.remove(1, 2), QVector<int>({3, 1}));
+    compare(sequence, {0, 2, 4, 5});
+    QVERIFY(!sequence.contains(3));
+    QCOMPARE(sequence.positionOf(1), -1);
+    QCOMPARE(sequence.ids(1, 10), QVector<int>({2, 4, 5}));
+
+    // A removed id can be placed again
+    sequence.insert(0, 3);
+    compare(sequence, {3, 0, 2, 4, 5});
+
+    sequence.remove(0, sequence.size());
+    compare(sequence, {});
+}
+
+void TestBlockSequence::randomEdits()
+{
+    QRandomGenerator random(1);
+    BlockSequence sequence;
+    QVector<int> expected;
+    QVector<int> freeIds;
+    int nextId = 0;
+
+    for (int step = 0; step < 2000; step++) {
+        if (expected.isEmpty() || random.bounded(3) != 0) {
+            QVector<int> ids;
+            for (int count = 1 + random.bounded(8); count > 0; count--)
+                ids.append(freeIds.isEmpty() ? nextId++ : freeIds.takeLast());
+
+            auto position = random.bounded(expected.size() + 1);
+            sequence.insert(position, ids);
+            for (int i = 0; i < ids.size(); i++)
+                expected.insert(position + i, ids[i]);
+        }
+        else {
+            auto position = random.bounded(expected.size());
+            auto count = 1 + random.bounded(qMin(8, expected.size() - position));
+            auto removed = sequence.remove(position, count);
+            QCOMPARE(removed, expected.mid(position, count));
+            expected.remove(position, count);
+            freeIds += removed;
+        }
+
+        if (step % 100 == 0)
+            compare(sequence, expected);
+    }
+    compare(sequence, expected);
+}
+
+void TestBlockSequence::firstAfter()
+{
+    BlockSequence sequence;
+    sequence.insert(0, {0, 1, 2, 3});
+    for (int id = 0; id < 4; id++)
+        sequence.setTime(id, (id + 1) * 1000);
+
+    QCOMPARE(sequence.firstAfter(0), 0);
+    QCOMPARE(sequence.firstAfter(1000), 1);
+    QCOMPARE(sequence.firstAfter(3500), 3);
+    QCOMPARE(sequence.firstAfter(4000), -1);
+
+    // Out of order time stamps still give the first block past the time
+    sequence.setTime(1, 5000);
+    QCOMPARE(sequence.firstAfter(1000), 1);
+    QCOMPARE(sequence.firstAfter(4500), 1);
+}
+
+QTEST_APPLESS_MAIN(TestBlockSequence)
+
+#include "tst_blocksequence.moc"
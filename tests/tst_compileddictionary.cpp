@@ -0,0 +1,50 @@
+#include "editor/compileddictionary.h"
+#include "editor/dictionary.h"
+
+#include <QtTest>
+
+class TestCompiledDictionary : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void acceptsItsList_data();
+    void acceptsItsList();
+};
+
+void TestCompiledDictionary::acceptsItsList_data()
+{
+    QTest::addColumn<QString>("language");
+
+    for (auto& fileName: QDir(WORDLISTS_DIR).entryList({"*.txt"}, QDir::Files))
+        QTest::newRow(qPrintable(fileName)) << QFileInfo(fileName).completeBaseName();
+}
+
+// The dictionary the build compiled holds every word of its list and nothing else, the forms of a
+// stem found with the paradigms included
+void TestCompiledDictionary::acceptsItsList()
+{
+    QFETCH(QString, language);
+
+    // Read as compile-dictionary reads it
+    QFile list(QString(WORDLISTS_DIR "/%1.txt").arg(language));
+    QVERIFY(list.open(QFile::ReadOnly));
+    QStringList keys;
+    while (!list.atEnd()) {
+        auto line = list.readLine().trimmed();
+        if (!line.isEmpty())
+            keys << Dictionary::normalizedKey(QString::fromUtf8(line));
+    }
+    std::sort(keys.begin(), keys.end());
+    keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+
+    CompiledDictionary dictionary;
+    QVERIFY(dictionary.load(QString(DICTIONARIES_DIR "/%1.dic").arg(language)));
+    QCOMPARE(dictionary.words(), keys);
+    for (auto& key: qAsConst(keys))
+        QVERIFY2(dictionary.contains(key, Dictionary::keyHash(key)), qPrintable(key));
+}
+
+QTEST_APPLESS_MAIN(TestCompiledDictionary)
+
+#include "tst_compileddictionary.moc"
@@ -0,0 +1,86 @@
+#include "editor/dictionary.h"
+
+#include <QtTest>
+
+class TestDictionary : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void normalizedKey_data();
+    void normalizedKey();
+    void insertAndLookup();
+    void growth();
+};
+
+void TestDictionary::normalizedKey_data()
+{
+    QTest::addColumn<QString>("word");
+    QTest::addColumn<QString>("key");
+
+    QTest::newRow("lowered") << "Hello" << "hello";
+    QTest::newRow("trailing mark") << "hello," << "hello";
+    QTest::newRow("one mark only") << "wait..." << "wait..";
+    QTest::newRow("inner mark kept") << "e.g" << "e.g";
+    QTest::newRow("mark alone") << "." << "";
+    QTest::newRow("empty") << "" << "";
+    QTest::newRow("case folded") << QString::fromUtf8("ÉCOLE!") << QString::fromUtf8("école");
+    QTest::newRow("composed") << QString::fromUtf8("Cafe\xcc\x81") << QString::fromUtf8("caf\xc3\xa9");
+    QTest::newRow("devanagari") << QString::fromUtf8("नमस्ते,") << QString::fromUtf8("नमस्ते");
+    QTest::newRow("gujarati") << QString::fromUtf8("કેમ;") << QString::fromUtf8("કેમ");
+}
+
+void TestDictionary::normalizedKey()
+{
+    QFETCH(QString, word);
+    QFETCH(QString, key);
+
+    QCOMPARE(Dictionary::normalizedKey(word), key);
+    // The hash is of the key, not of how the word was spelt
+    QCOMPARE(Dictionary::keyHash(Dictionary::normalizedKey(word)), Dictionary::keyHash(key));
+}
+
+void TestDictionary::insertAndLookup()
+{
+    Dictionary dictionary;
+    QVERIFY(dictionary.isEmpty());
+    QVERIFY(!dictionary.containsWord(QString("hello")));
+
+    auto index = dictionary.insert(QString("Hello"));
+    QCOMPARE(dictionary.size(), 1);
+    QCOMPARE(dictionary.key(index).toString(), QString("hello"));
+
+    // Spellings of the same key share its entry
+    QCOMPARE(dictionary.insert(QString("HELLO.")), index);
+    QCOMPARE(dictionary.size(), 1);
+    QVERIFY(dictionary.containsWord(QString("hello!")));
+    QVERIFY(dictionary.contains(QString("hello"), Dictionary::keyHash(QString("hello"))));
+    QVERIFY(!dictionary.containsWord(QString("hell")));
+
+    dictionary.insert(QString("there"));
+    QCOMPARE(dictionary.keys(), QStringList({"hello", "there"}));
+    QCOMPARE(dictionary.indexOf(QString("there"), Dictionary::keyHash(QString("there"))), 1);
+
+    dictionary.clear();
+    QVERIFY(dictionary.isEmpty());
+    QVERIFY(!dictionary.containsWord(QString("hello")));
+}
+
+// Keys stay where they were inserted while the table is rehashed around them
+void TestDictionary::growth()
+{
+    Dictionary dictionary;
+    for (int i = 0; i < 5000; i++)
+        QCOMPARE(dictionary.insert(QString("Word%1").arg(i)), i);
+
+    QCOMPARE(dictionary.size(), 5000);
+    for (int i = 0; i < 5000; i++) {
+        auto key = QString("word%1").arg(i);
+        QCOMPARE(dictionary.indexOf(key, Dictionary::keyHash(key)), i);
+    }
+    QVERIFY(!dictionary.containsWord(QString("word5000")));
+}
+
+QTEST_APPLESS_MAIN(TestDictionary)
+
+#include "tst_dictionary.moc"
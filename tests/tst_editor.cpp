@@ -0,0 +1,120 @@
+#include "editor/editor.h"
+
+#include <QTemporaryDir>
+#include <QtTest>
+
+class TestEditor : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void typing();
+    void markWordAsCorrect();
+
+private:
+    static QStringList wordTexts(const Editor& editor, int blockNumber);
+    static int invalidWordCount(const Editor& editor, int blockNumber);
+
+    // Corrected words are written to the working directory
+    QTemporaryDir m_directory;
+};
+
+// The test binary has no compiled dictionaries, english is read from a plain list in the test
+// data directory
+void TestEditor::initTestCase()
+{
+    QVERIFY(m_directory.isValid());
+    QDir::setCurrent(m_directory.path());
+
+    QStandardPaths::setTestModeEnabled(true);
+    QDir dataDirectory(QStandardPaths::writableLocation(QStandardPaths::AppDataLocation));
+    QVERIFY(dataDirectory.mkpath("wordlists"));
+
+    QFile list(dataDirectory.filePath("wordlists/english.txt"));
+    QVERIFY(list.open(QFile::WriteOnly | QFile::Truncate));
+    list.write("again\nhello\nthe\nthere\nworld\n");
+}
+
+QStringList TestEditor::wordTexts(const Editor& editor, int blockNumber)
+{
+    QStringList texts;
+    for (auto& w: editor.m_transcript.words(blockNumber))
+        texts.append(w.text);
+    return texts;
+}
+
+// The words marked on the line, as the highlighter underlines them
+int TestEditor::invalidWordCount(const Editor& editor, int blockNumber)
+{
+    auto data = static_cast<BlockData*>(editor.document()->findBlockByNumber(blockNumber).userData());
+    return data ? data->invalidWords.count(true) : -1;
+}
+
+// Every keystroke is a change of its own, the words written to the transcript have to follow the
+// text and not the tokens cached on the line before it
+void TestEditor::typing()
+{
+    Editor editor;
+    editor.show();
+    QVERIFY(QTest::qWaitForWindowExposed(&editor));
+
+    QTest::keyClicks(&editor, "[Speaker 1]: hello world [00:00:01.000]");
+    QCOMPARE(editor.m_transcript.blockCount(), 1);
+    QCOMPARE(editor.m_transcript.speaker(0), QString("Speaker 1"));
+    QCOMPARE(editor.m_transcript.blockTime(0), qint64(1000));
+    QCOMPARE(wordTexts(editor, 0), QStringList({"hello", "world"}));
+
+    // In the middle of the line, inside and between words
+    auto cursor = editor.textCursor();
+    cursor.setPosition(QString("[Speaker 1]: hello").size());
+    editor.setTextCursor(cursor);
+    QTest::keyClicks(&editor, "o there");
+    QCOMPARE(wordTexts(editor, 0), QStringList({"helloo", "there", "world"}));
+
+    QTest::keyClick(&editor, Qt::Key_Backspace);
+    QTest::keyClick(&editor, Qt::Key_Backspace);
+    QCOMPARE(wordTexts(editor, 0), QStringList({"helloo", "the", "world"}));
+    QCOMPARE(editor.m_transcript.blockTime(0), qint64(1000));
+
+    // A line typed below keeps its own words and leaves the first one as it was
+    cursor.movePosition(QTextCursor::End);
+    editor.setTextCursor(cursor);
+    QTest::keyClick(&editor, Qt::Key_Return);
+    QTest::keyClicks(&editor, "[Speaker 2]: again [00:00:02.000]");
+    QCOMPARE(editor.m_transcript.blockCount(), 2);
+    QCOMPARE(wordTexts(editor, 0), QStringList({"helloo", "the", "world"}));
+    QCOMPARE(wordTexts(editor, 1), QStringList({"again"}));
+    QCOMPARE(editor.m_transcript.blockTime(1), qint64(2000));
+}
+
+// Only the lines with the word are checked again. The line with a word corrected behind the editor's
+// back keeps its mark, which a pass over the whole transcript would have cleared.
+void TestEditor::markWordAsCorrect()
+{
+    Editor editor;
+    QTRY_VERIFY(!editor.m_dictionary.isNull());
+    QTRY_COMPARE(editor.m_validationTasksLeft, 0);
+
+    editor.setPlainText("[Speaker 1]: hello wrold [00:00:01.000]\n"
+                        "[Speaker 1]: teh world [00:00:02.000]\n"
+                        "[Speaker 2]: wrold again [00:00:03.000]");
+    QCOMPARE(editor.m_transcript.blockCount(), 3);
+    QCOMPARE(invalidWordCount(editor, 0), 1);
+    QCOMPARE(invalidWordCount(editor, 1), 1);
+    QCOMPARE(invalidWordCount(editor, 2), 1);
+    QCOMPARE(editor.m_transcript.invalidWordCount(), 3);
+
+    QVERIFY(editor.m_correctedWords.append(QString("teh"), Dictionary::keyHash(QString("teh"))));
+    editor.markWordAsCorrect(0, 1);
+
+    QCOMPARE(invalidWordCount(editor, 0), 0);
+    QCOMPARE(invalidWordCount(editor, 1), 1);
+    QCOMPARE(invalidWordCount(editor, 2), 0);
+    QCOMPARE(editor.m_transcript.invalidWordCount(), 1);
+    QVERIFY(editor.m_correctedWords.contains(QString("wrold"), Dictionary::keyHash(QString("wrold"))));
+}
+
+QTEST_MAIN(TestEditor)
+
+#include "tst_editor.moc"
@@ -0,0 +1,212 @@
+#include "editor/transcript.h"
+
+#include <QRandomGenerator>
+#include <QtTest>
+
+class TestTranscript : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void undoRedo();
+    void undoRedoThroughCompaction();
+    void renameSpeaker();
+
+private:
+    // Every block and word with its time stamp, speaker and tags, one line each
+    static QStringList state(const Transcript& transcript);
+    static QVector<word> makeWords(QRandomGenerator& random, int count);
+    static void edit(Transcript& transcript, QRandomGenerator& random);
+};
+
+QStringList TestTranscript::state(const Transcript& transcript)
+{
+    QStringList lines;
+    for (int i = 0; i < transcript.blockCount(); i++) {
+        QStringList words;
+        for (auto& w: transcript.words(i))
+            words.append(QString("%1@%2[%3]").arg(w.text).arg(w.timeStamp).arg(w.tagList.join(',')));
+        lines.append(QString("%1 %2 [%3]: %4").arg(transcript.blockTime(i)).arg(transcript.speaker(i))
+                             .arg(transcript.blockTags(i).join(','), words.join(' ')));
+    }
+    return lines;
+}
+
+QVector<word> TestTranscript::makeWords(QRandomGenerator& random, int count)
+{
+    static const QStringList texts{"the", "Recording", "starts", "नमस्ते", "आप", "કેમ", "છો", "okay,"};
+    static const QStringList tags{"Lang_hindi", "Noise"};
+
+    QVector<word> words;
+    for (int i = 0; i < count; i++) {
+        QStringList tagList;
+        if (random.bounded(8) == 0)
+            tagList.append(tags[random.bounded(tags.size())]);
+        words.append(word {random.bounded(2) ? qint64(random.bounded(100000)) : qint64(-1),
+                           texts[random.bounded(texts.size())], tagList});
+    }
+    return words;
+}
+
+// One command of a random kind, the ones that rewrite words dominate so compactions happen
+void TestTranscript::edit(Transcript& transcript, QRandomGenerator& random)
+{
+    auto blockNumber = random.bounded(transcript.blockCount());
+    transcript.beginCommand("Edit");
+
+    transcript.setWords(blockNumber, makeWords(random, 40 + random.bounded(40)));
+
+    switch (random.bounded(6)) {
+    case 0:
+        transcript.setWordText(blockNumber, random.bounded(transcript.wordCount(blockNumber)), "changed");
+        break;
+    case 1:
+        transcript.splitBlock(blockNumber, random.bounded(transcript.wordCount(blockNumber) + 1));
+        break;
+    case 2:
+        if (blockNumber + 1 < transcript.blockCount())
+            transcript.mergeBlocks(blockNumber);
+        break;
+    case 3:
+        transcript.insertBlock(blockNumber, block {1000, "", "Speaker 2", {}, makeWords(random, 5)});
+        break;
+    case 4:
+        if (transcript.blockCount() > 1)
+            transcript.removeBlock(blockNumber);
+        break;
+    default:
+        transcript.setSpeaker(blockNumber, "Speaker 3");
+        transcript.setBlockTags(blockNumber, {"Lang_gujarati"});
+        transcript.setWordTime(blockNumber, 0, 42);
+    }
+
+    transcript.endCommand();
+}
+
+void TestTranscript::undoRedo()
+{
+    Transcript transcript;
+    transcript.appendBlock(block {1000, "", "Speaker 1", {}, {word {500, "hello", {}}, word {1000, "there", {}}}});
+    transcript.appendBlock(block {2000, "", "Speaker 2", {}, {word {-1, "again", {}}}});
+    auto initial = state(transcript);
+    QVERIFY(!transcript.canUndo());
+
+    transcript.beginCommand("Split");
+    transcript.splitBlock(0, 1);
+    transcript.endCommand();
+    auto split = state(transcript);
+    QCOMPARE(transcript.blockCount(), 3);
+    QCOMPARE(transcript.wordText(1, 0).toString(), QString("there"));
+
+    transcript.beginCommand("Merge");
+    transcript.mergeBlocks(1);
+    transcript.setWordText(1, 1, "once");
+    transcript.endCommand();
+    auto merged = state(transcript);
+    QCOMPARE(transcript.blockCount(), 2);
+    QCOMPARE(transcript.undoText(), QString("Merge"));
+
+    transcript.undo();
+    QCOMPARE(state(transcript), split);
+    transcript.undo();
+    QCOMPARE(state(transcript), initial);
+    QVERIFY(!transcript.canUndo());
+
+    transcript.redo();
+    QCOMPARE(state(transcript), split);
+    transcript.redo();
+    QCOMPARE(state(transcript), merged);
+    QVERIFY(!transcript.canRedo());
+}
+
+// The history holds about 6000 words written after the first 400, past the point where the dead
+// ones are compacted away, so the records it restores must have followed the compaction
+void TestTranscript::undoRedoThroughCompaction()
+{
+    QRandomGenerator random(1);
+    Transcript transcript;
+    for (int i = 0; i < 20; i++)
+        transcript.appendBlock(block {qint64(i) * 1000, "", "Speaker 1", {}, makeWords(random, 20)});
+
+    QVector<QStringList> states{state(transcript)};
+    for (int i = 0; i < 100; i++) {
+        edit(transcript, random);
+        states.append(state(transcript));
+    }
+
+    for (int i = states.size() - 2; i >= 0; i--) {
+        QVERIFY(transcript.canUndo());
+        transcript.undo();
+        QCOMPARE(state(transcript), states[i]);
+    }
+    QVERIFY(!transcript.canUndo());
+
+    for (int i = 1; i < states.size(); i++) {
+        QVERIFY(transcript.canRedo());
+        transcript.redo();
+        QCOMPARE(state(transcript), states[i]);
+    }
+
+    // Editing again after undoing half of it drops the rest and compacts with a shorter history
+    for (int i = 0; i < 50; i++)
+        transcript.undo();
+    for (int i = 0; i < 60; i++)
+        edit(transcript, random);
+    QVERIFY(!transcript.canRedo());
+    auto edited = state(transcript);
+    for (int i = 0; i < 60; i++)
+        transcript.undo();
+    QCOMPARE(state(transcript), states[50]);
+    for (int i = 0; i < 60; i++)
+        transcript.redo();
+    QCOMPARE(state(transcript), edited);
+}
+
+// Every block of the speaker moves to the other one, the turns follow them and undo gives them back
+void TestTranscript::renameSpeaker()
+{
+    Transcript transcript;
+    for (auto speaker: {"Speaker 1", "Speaker 2", "Speaker 1", "Speaker 3", "Speaker 1"})
+        transcript.appendBlock(block {-1, "", speaker, {}, {word {-1, "hello", {}}}});
+    auto initial = state(transcript);
+    transcript.clearChanges();
+
+    transcript.beginCommand("Change Speaker");
+    transcript.renameSpeaker("Speaker 1", "Speaker 2");
+    transcript.endCommand();
+    auto renamed = state(transcript);
+
+    QCOMPARE(transcript.speakers(), QStringList({"Speaker 2", "Speaker 3"}));
+    QCOMPARE(transcript.speakerBlocks("Speaker 2"), QVector<int>({0, 1, 2, 4}));
+    QVERIFY(transcript.speakerBlocks("Speaker 1").isEmpty());
+    QCOMPARE(transcript.nextSpeakerTurn(1), 2);
+    QCOMPARE(transcript.previousSpeakerTurn(4), 2);
+    QCOMPARE(transcript.changes().first, 0);
+    QCOMPARE(transcript.changes().added, 5);
+
+    // To a speaker with no blocks yet
+    auto revision = transcript.speakersRevision();
+    transcript.beginCommand("Change Speaker");
+    transcript.renameSpeaker("Speaker 3", "Speaker 4");
+    transcript.endCommand();
+    QVERIFY(transcript.speakersRevision() != revision);
+    QCOMPARE(transcript.speakers(), QStringList({"Speaker 2", "Speaker 4"}));
+    QCOMPARE(transcript.speakerBlocks("Speaker 4"), QVector<int>({3}));
+
+    transcript.undo();
+    QCOMPARE(state(transcript), renamed);
+    transcript.undo();
+    QCOMPARE(state(transcript), initial);
+    QCOMPARE(transcript.speakers(), QStringList({"Speaker 1", "Speaker 2", "Speaker 3"}));
+    QCOMPARE(transcript.speakerBlocks("Speaker 1"), QVector<int>({0, 2, 4}));
+    QCOMPARE(transcript.speakerBlocks("Speaker 2"), QVector<int>({1}));
+    QCOMPARE(transcript.nextSpeakerTurn(0), 2);
+
+    transcript.redo();
+    QCOMPARE(state(transcript), renamed);
+    QCOMPARE(transcript.speakerBlocks("Speaker 2"), QVector<int>({0, 1, 2, 4}));
+}
+
+QTEST_APPLESS_MAIN(TestTranscript)
+
+#include "tst_transcript.moc"
@@ -3,6 +3,7 @@
 #include "editor/utilities/keyboardshortcutguide.h"
 
 #include <QFontDialog>
+#include <QLabel>
 
 Tool::Tool(QWidget *parent)
     : QMainWindow(parent)
@@ -49,15 +50,16 @@ Tool::Tool(QWidget *parent)
     connect(player, &MediaPlayer::message, this->statusBar(), &QStatusBar::showMessage);
     connect(player, QOverload<QMediaPlayer::Error>::of(&QMediaPlayer::error), this, &Tool::handleMediaPlayerError);
 
-    // Connect components dependent on Player's position change to player
+    // Connect components dependent on Player's position change to player, the transcript follows
+    // the interpolated playhead so the highlight moves smoothly between position updates
     connect(player, &QMediaPlayer::positionChanged, this,
         [&]()
         {
             ui->slider_position->setValue(player->position());
             ui->label_position->setText(player->getPositionInfo());
-            ui->m_editor->highlightTranscript(player->elapsedTime());
         }
     );
+    connect(player, &MediaPlayer::playheadMoved, ui->m_editor, &Editor::highlightTranscript);
 
     connect(player, &QMediaPlayer::durationChanged, this,
         [&]()
@@ -90,6 +92,8 @@ Tool::Tool(QWidget *parent)
     connect(ui->editor_saveAs, &QAction::triggered, ui->m_editor, &Editor::transcriptSaveAs);
     connect(ui->editor_close, &QAction::triggered, ui->m_editor, &Editor::transcriptClose);
     connect(ui->editor_jumpToLine, &QAction::triggered, ui->m_editor, &Editor::jumpToHighlightedLine);
+    connect(ui->editor_nextInvalidWord, &QAction::triggered, ui->m_editor, &Editor::nextInvalidWord);
+    connect(ui->editor_previousInvalidWord, &QAction::triggered, ui->m_editor, &Editor::previousInvalidWord);
     connect(ui->editor_splitLine, &QAction::triggered, ui->m_editor, [&]() {ui->m_editor->splitLine(player->elapsedTime());});
     connect(ui->editor_mergeUp, &QAction::triggered, ui->m_editor, &Editor::mergeUp);
     connect(ui->editor_mergeDown, &QAction::triggered, ui->m_editor, &Editor::mergeDown);
@@ -103,6 +107,12 @@ Tool::Tool(QWidget *parent)
     connect(ui->m_editor, &Editor::jumpToPlayer, player, &MediaPlayer::setPositionToTime);
     connect(ui->m_editor, &Editor::refreshTagList, ui->m_tagListDisplay, &TagListDisplayWidget::refreshTags);
 
+    auto invalidWordCount = new QLabel(this);
+    statusBar()->addPermanentWidget(invalidWordCount);
+    connect(ui->m_editor, &Editor::invalidWordCountChanged, invalidWordCount, [invalidWordCount](int count) {
+        invalidWordCount->setText(count ? QString("Misspelt words: %1").arg(count) : QString());
+    });
+
     auto useTransliterationMenu = new QMenu("Use Transliteration", ui->menuEditor);
     auto group = new QActionGroup(this);
     auto langs = m_transliterationLang.keys();
@@ -0,0 +1,69 @@
+// Builds the n-gram model read by NGramModel from corrected transcripts, the
+// XML files the editor saves. The model is written for the language of the
+// transcripts given, the editor loads it from ngrams_<language>.bin beside its
+// executable or in its data directory.
+
+#include "editor/dictionary.h"
+#include "editor/ngrammodel.h"
+
+#include <QFile>
+#include <QXmlStreamReader>
+#include <cstdio>
+
+static bool readLines(const char* fileName, QVector<QStringList>& lines)
+{
+    QFile file(QString::fromLocal8Bit(fileName));
+    if (!file.open(QFile::ReadOnly))
+        return false;
+
+    QXmlStreamReader reader(&file);
+    if (!reader.readNextStartElement() || reader.name() != "transcript")
+        return false;
+
+    while (reader.readNextStartElement()) {
+        if (reader.name() != "line") {
+            reader.skipCurrentElement();
+            continue;
+        }
+
+        QStringList line;
+        while (reader.readNextStartElement()) {
+            if (reader.name() != "word") {
+                reader.skipCurrentElement();
+                continue;
+            }
+            auto key = Dictionary::normalizedKey(reader.readElementText());
+            if (!key.isEmpty())
+                line.append(key);
+        }
+        if (!line.isEmpty())
+            lines.append(line);
+    }
+
+    return !reader.hasError();
+}
+
+int main(int argc, char *argv[])
+{
+    if (argc < 3) {
+        fprintf(stderr, "Usage: %s <model> <transcript>...\n", argv[0]);
+        return 1;
+    }
+
+    QVector<QStringList> lines;
+    for (int i = 2; i < argc; i++) {
+        if (!readLines(argv[i], lines)) {
+            fprintf(stderr, "Couldn't read %s\n", argv[i]);
+            return 1;
+        }
+    }
+
+    QFile output(QString::fromLocal8Bit(argv[1]));
+    auto data = NGramModel::build(lines);
+    if (!output.open(QFile::WriteOnly | QFile::Truncate) || output.write(data) != data.size()) {
+        fprintf(stderr, "Couldn't write %s\n", argv[1]);
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,41 @@
+// Compiles a word list, one word per line, into the format read by
+// CompiledDictionary. Run by the build for every list in editor/wordlists.
+// With --affixes the list is stored as stems and the paradigms of endings
+// they take, found from the list.
+
+#include "editor/compileddictionary.h"
+
+#include <QFile>
+#include <cstdio>
+
+int main(int argc, char *argv[])
+{
+    auto affixes = argc == 4 && qstrcmp(argv[1], "--affixes") == 0;
+    if (argc != 3 && !affixes) {
+        fprintf(stderr, "Usage: %s [--affixes] <word list> <dictionary>\n", argv[0]);
+        return 1;
+    }
+    auto inputName = argv[argc - 2], outputName = argv[argc - 1];
+
+    QFile input(QString::fromLocal8Bit(inputName));
+    if (!input.open(QFile::ReadOnly)) {
+        fprintf(stderr, "Couldn't open %s\n", inputName);
+        return 1;
+    }
+
+    QStringList words;
+    while (!input.atEnd()) {
+        auto line = input.readLine().trimmed();
+        if (!line.isEmpty())
+            words << QString::fromUtf8(line);
+    }
+
+    QFile output(QString::fromLocal8Bit(outputName));
+    auto data = CompiledDictionary::compile(words, affixes);
+    if (!output.open(QFile::WriteOnly | QFile::Truncate) || output.write(data) != data.size()) {
+        fprintf(stderr, "Couldn't write %s\n", outputName);
+        return 1;
+    }
+
+    return 0;
+}